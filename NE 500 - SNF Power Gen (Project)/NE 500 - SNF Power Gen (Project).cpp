@@ -103,7 +103,7 @@ int main()
 	std::cout << "test rankine efficiency: " << test_eta << std::endl;
 	study_s1.execute();
 	study_s1.write();
-	vector <double> lh_study_out = res_study(test_lot, lh_study_res);
+	vector <double> lh_study_out = res_sweep(test_lot, lh_study_res);
 	write2csv(lh_study_out, lh_study_fileName, lh_study_width, lh_study_length);
 	vector <double> hs_study_temp;
 }
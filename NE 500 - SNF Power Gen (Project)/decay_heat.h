@@ -12,24 +12,265 @@
 #include <iostream>
 #include <cstring>
 #include <cmath>
+#include <cfloat>
+#include <vector>
+#include <algorithm>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 //	--== constants ==--
-const double ans_coef[6][2] = { {-0.00614575,	0.060157	},
+constexpr double ans_coef[6][2] = { {-0.00614575,	0.060157	},
 								{0.14058,		-0.286		},
 								{0.8703,		-0.4255		},
 								{12.842,		-0.6014		},
 								{40683,			-1.0675		},
 								{0.000039113,	-0.00000000073541} };
 
+const double dh_pi = 3.14159265358979323846;
+
+//	ans79_u235:	ANS-5.1-1979 23-group decay heat fit for thermal fission of U-235; {alpha_i (MeV/fission-s), lambda_i (1/s)}
+const double ans79_u235[23][2] = {	{6.5057E-01,	2.2138E+01},
+									{5.1264E-01,	5.1587E-01},
+									{2.4384E-01,	1.9594E-01},
+									{1.3850E-01,	1.0314E-01},
+									{5.5440E-02,	3.3656E-02},
+									{2.2225E-02,	1.1681E-02},
+									{3.3088E-03,	3.5870E-03},
+									{9.3015E-04,	1.3930E-03},
+									{8.0943E-04,	6.2630E-04},
+									{1.9567E-04,	1.8906E-04},
+									{3.2535E-05,	5.4988E-05},
+									{7.5595E-06,	2.0958E-05},
+									{2.5232E-06,	1.0010E-05},
+									{4.9948E-07,	2.5438E-06},
+									{1.8531E-07,	6.6361E-07},
+									{2.6608E-08,	1.2290E-07},
+									{2.2398E-09,	2.7213E-08},
+									{8.1641E-12,	4.3714E-09},
+									{8.7797E-11,	7.5780E-10},
+									{2.5131E-14,	2.4786E-10},
+									{3.2176E-16,	2.2384E-13},
+									{4.5038E-17,	2.4600E-14},
+									{7.4791E-17,	1.5699E-14} };
+
+const double q_fission = 200;		//recoverable energy per fission (MeV), normalizes group sums to a fraction of full power
+
 //const double httr_cf[3][4];
 
-//	--== structs ==--
+//	--== dual numbers ==--
+//	dual<N> carries a value and its derivatives with respect to N seeded inputs, so the templated kernels below return a result and
+//	its gradient in one pass. Comparisons act on the value only, which keeps bin and region selection identical to the double path.
+template <int N>
+struct dual {
+	double v;			//value
+	double d[N];		//derivatives with respect to each seeded input
+
+	dual(double x = 0) {
+		v = x;
+		for (int i = 0; i < N; i++) {
+			d[i] = 0;
+		};
+	}
+
+	//	var():	an input x seeded as variable i
+	static dual var(double x, int i) {
+		dual r(x);
+		r.d[i] = 1;
+		return r;
+	}
+
+	friend dual operator+(const dual& a, const dual& b) {
+		dual r(a.v + b.v);
+		for (int i = 0; i < N; i++) {
+			r.d[i] = a.d[i] + b.d[i];
+		};
+		return r;
+	}
+	friend dual operator-(const dual& a, const dual& b) {
+		dual r(a.v - b.v);
+		for (int i = 0; i < N; i++) {
+			r.d[i] = a.d[i] - b.d[i];
+		};
+		return r;
+	}
+	friend dual operator-(const dual& a) {
+		return dual(0) - a;
+	}
+	friend dual operator*(const dual& a, const dual& b) {
+		dual r(a.v * b.v);
+		for (int i = 0; i < N; i++) {
+			r.d[i] = a.d[i] * b.v + a.v * b.d[i];
+		};
+		return r;
+	}
+	friend dual operator/(const dual& a, const dual& b) {
+		dual r(a.v / b.v);
+		for (int i = 0; i < N; i++) {
+			r.d[i] = (a.d[i] - r.v * b.d[i]) / b.v;
+		};
+		return r;
+	}
+	dual& operator+=(const dual& b) {
+		return *this = *this + b;
+	}
+	dual& operator*=(const dual& b) {
+		return *this = *this * b;
+	}
+
+	friend bool operator<(const dual& a, const dual& b) { return a.v < b.v; }
+	friend bool operator<=(const dual& a, const dual& b) { return a.v <= b.v; }
+	friend bool operator>(const dual& a, const dual& b) { return a.v > b.v; }
+	friend bool operator>=(const dual& a, const dual& b) { return a.v >= b.v; }
+
+	//	chain():	applies the chain rule for an outer function with value f and slope df at a.v
+	static dual chain(const dual& a, double f, double df) {
+		dual r(f);
+		for (int i = 0; i < N; i++) {
+			r.d[i] = df * a.d[i];
+		};
+		return r;
+	}
+	friend dual exp(const dual& a) {
+		double f = std::exp(a.v);
+		return chain(a, f, f);
+	}
+	friend dual log(const dual& a) {
+		return chain(a, std::log(a.v), 1 / a.v);
+	}
+	friend dual pow(const dual& a, double p) {
+		double f = std::pow(a.v, p);
+		return chain(a, f, p * f / a.v);
+	}
+	friend dual fmax(const dual& a, const dual& b) {
+		return (a.v >= b.v) ? a : b;
+	}
+
+	friend std::ostream& operator<<(std::ostream& os, const dual& a) {
+		return os << a.v;
+	}
+};
+
+//	dh_val:	value part of a scalar, for selecting bins and regions
+inline double dh_val(double x) {
+	return x;
+}
+template <int N>
+inline double dh_val(const dual<N>& x) {
+	return x.v;
+}
+
+//	--== correlation policies ==--
+//	A policy fixes one decay heat calibration at compile time: n_bnd bin boundaries <bnd>, the fit recast into rows <form> of the single
+//	expression q = A*exp(B*ln(ts) + C*ts) + D*ln(ts) + E (one row per coefficient A-E, one column per bin, with the outermost columns
+//	catching out-of-bound times and evaluating to 0), n_cbnd correction region boundaries <cbnd>, the correction factor cf(ts), and
+//	region(ts) with <cf_flat> marking the regions where cf is constant.
+//	Kernels, surrogates, dh_profile_t, lot_t and lotArray_t are templated on a policy, so each instantiation reads its tables as
+//	constants and carries no branch on which model is active.
+
+//	ans_tk:	ans_coef fit with the HTTR-calibrated correction regions I, II, III and III+ used by corr_fin
+struct ans_tk {
+	static constexpr int n_bnd = 7;
+	static constexpr double bnd[n_bnd] = { 1.5, 400, 400000, 4000000, 40000000, 400000000, 10000000000 };
+	static constexpr double form[5][n_bnd + 1] = {	{0,	0,				ans_coef[1][0],	ans_coef[2][0],	ans_coef[3][0],	ans_coef[4][0],	ans_coef[5][0],	0},
+													{0,	0,				ans_coef[1][1],	ans_coef[2][1],	ans_coef[3][1],	ans_coef[4][1],	0,				0},
+													{0,	0,				0,				0,				0,				0,				ans_coef[5][1],	0},
+													{0,	ans_coef[0][0],	0,				0,				0,				0,				0,				0},
+													{0,	ans_coef[0][1],	0,				0,				0,				0,				0,				0} };
+
+	//	cform:	correction factors recast into the single form cf = P*exp(Q*(ts - 1E+07)) + R*ln(S*(ts - 3E+07) + 1) + U; one row per
+	//			coefficient P-U and one column per region I, II, III, III+
+	static constexpr int n_cbnd = 3;
+	static constexpr double cbnd[n_cbnd] = { 10000000, 27000000, 125000000 };
+	static constexpr double cform[5][n_cbnd + 1] = {	{0,			0.9,			0,				0		},
+														{0,			-0.000000022,	0,				0		},
+														{0,			0,				0.3,			0		},
+														{0,			0,				0.0000000415,	0		},
+														{0.7724,	0,				0.6202,			1.05	} };
+
+	static constexpr bool cf_flat[n_cbnd + 1] = { true, false, false, true };		//regions where cf is constant
+
+	static long long region(double ts) {
+		return (ts >= cbnd[0]) + (ts >= cbnd[1]) + (ts >= cbnd[2]) + 3 * (ts < bnd[0]);
+	}
+
+	template <class T>
+	static T cf(T ts) {
+		using std::exp;				//float overloads for float T; dual<N> resolves to its own by ADL
+		using std::log;
+		using std::fmax;
+		long long r = region(dh_val(ts));
+		return T(cform[0][r]) * exp(T(cform[1][r]) * (ts - T(cbnd[0]))) + T(cform[2][r]) * log(fmax(T(cform[3][r]) * (ts - T(30000000)) + 1, T(FLT_MIN))) + T(cform[4][r]);
+	}
+};
+constexpr int ans_tk::n_bnd;
+constexpr double ans_tk::bnd[];
+constexpr double ans_tk::form[][ans_tk::n_bnd + 1];
+constexpr int ans_tk::n_cbnd;
+constexpr double ans_tk::cbnd[];
+constexpr double ans_tk::cform[][ans_tk::n_cbnd + 1];
+constexpr bool ans_tk::cf_flat[];
+
+//	ans_tk_raw:	ans_coef fit without correction, matching ans_fin; <cform> is the constant 1 in every region, for the AVX2 kernels
+//				that read the correction from the table
+struct ans_tk_raw : ans_tk {
+	static constexpr double cform[5][n_cbnd + 1] = { {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {1, 1, 1, 1} };
+	static constexpr bool cf_flat[n_cbnd + 1] = { true, true, true, true };
+
+	static long long region(double /*ts*/) {
+		return 0;
+	}
+
+	template <class T>
+	static T cf(T /*ts*/) {
+		return T(1);
+	}
+};
+constexpr double ans_tk_raw::cform[][ans_tk::n_cbnd + 1];
+constexpr bool ans_tk_raw::cf_flat[];
+
+//	ans_tk_var:	ans_tk layout with run-time <form> and <cform> tables, one copy per thread, for sampling studies; set() loads a sample
+//				on the calling thread and reset() restores the ans_tk values. Bin and region boundaries stay fixed.
+struct ans_tk_var : ans_tk {
+	static thread_local double form[5][n_bnd + 1];
+	static thread_local double cform[5][n_cbnd + 1];
+
+	static void set(const double f[5][n_bnd + 1], const double c[5][n_cbnd + 1]) {
+		std::memcpy(form, f, sizeof(form));
+		std::memcpy(cform, c, sizeof(cform));
+	}
+
+	static void reset() {
+		set(ans_tk::form, ans_tk::cform);
+	}
+
+	template <class T>
+	static T cf(T ts) {
+		using std::exp;				//float overloads for float T; dual<N> resolves to its own by ADL
+		using std::log;
+		using std::fmax;
+		long long r = region(dh_val(ts));
+		return T(cform[0][r]) * exp(T(cform[1][r]) * (ts - T(cbnd[0]))) + T(cform[2][r]) * log(fmax(T(cform[3][r]) * (ts - T(30000000)) + 1, T(FLT_MIN))) + T(cform[4][r]);
+	}
+};
+thread_local double ans_tk_var::form[5][ans_tk::n_bnd + 1] = {	{0,	0,				ans_coef[1][0],	ans_coef[2][0],	ans_coef[3][0],	ans_coef[4][0],	ans_coef[5][0],	0},
+																{0,	0,				ans_coef[1][1],	ans_coef[2][1],	ans_coef[3][1],	ans_coef[4][1],	0,				0},
+																{0,	0,				0,				0,				0,				0,				ans_coef[5][1],	0},
+																{0,	ans_coef[0][0],	0,				0,				0,				0,				0,				0},
+																{0,	ans_coef[0][1],	0,				0,				0,				0,				0,				0} };
+thread_local double ans_tk_var::cform[5][ans_tk::n_cbnd + 1] = {	{0,			0.9,			0,				0		},
+																	{0,			-0.000000022,	0,				0		},
+																	{0,			0,				0.3,			0		},
+																	{0,			0,				0.0000000415,	0		},
+																	{0.7724,	0,				0.6202,			1.05	} };
 
 //	--== functions ==--
+//	Templated on the scalar type, so they take double or dual<N> arguments.
 
 //	ans_inf:	computes decay heat fraction of full power after infinitely long operation at ts seconds after s/d
-double ans_inf(double &ts) {
-	double q_frac;
+template <class T>
+T ans_inf(T& ts) {
+	T q_frac;
 	if (1.5 <= ts && ts < 400) {							//decay curve between 1.5 and 4E+02 s
 		q_frac = ans_coef[0][0] * log(ts) + ans_coef[0][1];
 	} else if (400 <= ts && ts < 400000) {					//decay curve between 4E+02 and 4E+05 s
@@ -52,14 +293,16 @@ double ans_inf(double &ts) {
 
 
 //	ans_fin:	computes decay heat fraction of full power after finite operating period
-double	ans_fin(double& ts, double& to) {
-	double tse = ts + to;
+template <class T>
+T ans_fin(T& ts, T& to) {
+	T tse = ts + to;
 	return ans_inf(ts) - ans_inf(tse);
 }
 
 //	corr_fin:	computes corrected decay heat fraction of full power after finite operation at ts seconds after s/d
-double corr_fin(double& ts, double &to) {
-	double q_frac;
+template <class T>
+T corr_fin(T& ts, T& to) {
+	T q_frac;
 	if (1.5 <= ts && ts < 10000000) {							//correction factor region I
 		q_frac = ans_fin(ts, to) * 0.7724;
 	} else if (10000000 <= ts && ts < 27000000) {				//correction factor region II
@@ -73,4 +316,1247 @@ double corr_fin(double& ts, double &to) {
 	return q_frac;
 }
 
+//	--== batch kernels ==--
+//	Evaluate n cooling times per call into caller-owned buffers; output buffers may alias the time buffer. Segments are picked by
+//	counting boundary crossings and evaluated through the policy's single form expression. With AVX2 enabled (/arch:AVX2 in the
+//	x64 Release build, -mavx2 elsewhere) the double kernels run four times per instruction through the explicit lanes below; the
+//	compilers leave the plain loops scalar under value-safe floating point, as exp and log have no vector form without fast-math.
+//	Bin indices are 64-bit so the coefficient gathers match the double lanes. Out-of-bound times evaluate to 0 without printing;
+//	they are tallied instead into an optional dh_status that the caller inspects, or passes to dh_report(), once the batch is done.
+
+//	dh_flag:	bits raised in dh_status::flags
+enum dh_flag {
+	DH_TS_LOW = 1,			//a time fell below the lower bound of the fit
+	DH_TS_HIGH = 2,			//a time reached the upper bound of the fit
+	DH_TSE_HIGH = 4,		//ts + to reached the upper bound of the fit, so the finite-operation term was dropped
+	DH_TO_ZERO = 8			//a corrected evaluation was requested with no operating period
+};
+
+//	dh_status:	out-of-range tally for one or more batch calls, kept in place of per-element messages
+struct dh_status {
+	unsigned flags;			//bitwise OR of dh_flag values
+	long long n_low;		//number of times below the lower bound of the fit
+	long long n_high;		//number of times at or past the upper bound of the fit
+	long long n_tse_high;	//number of times where ts + to reached the upper bound of the fit
+
+	dh_status() {
+		clear();
+	}
+
+	void clear() {
+		flags = 0;
+		n_low = 0;
+		n_high = 0;
+		n_tse_high = 0;
+	}
+
+	//	tally():	adds counts from a batch and raises the matching flags
+	void tally(long long lo, long long hi, long long tse_hi) {
+		n_low += lo;
+		n_high += hi;
+		n_tse_high += tse_hi;
+		flags |= (lo > 0 ? DH_TS_LOW : 0) | (hi > 0 ? DH_TS_HIGH : 0) | (tse_hi > 0 ? DH_TSE_HIGH : 0);
+	}
+};
+
+bool dh_silent = false;		//suppresses dh_report for silent runs, leaving out-of-range handling to callers reading dh_status
+
+//	dh_report:	prints a single summary line for a dh_status if any flag is raised; call after, never inside, a batch loop
+void dh_report(const dh_status& st, const char* src) {
+	if (st.flags == 0 || dh_silent) {
+		return;
+	}
+	if (st.flags == DH_TO_ZERO) {
+		std::cout << "error " << src << "	:	argument invalid, to = 0" << std::endl;
+		return;
+	}
+	std::cout << "error " << src << "	:	decay heat time out-of-bounds, n_low = " << st.n_low << ", n_high = " << st.n_high << ", n_tse_high = " << st.n_tse_high;
+	if (st.flags & DH_TO_ZERO) {
+		std::cout << ", to = 0";
+	}
+	std::cout << std::endl;
+}
+
+//	ans_inf_bf:		branch-free ans_inf for a single time, used as the inner kernel of the batch functions; T may be a dual<N>
+template <class P = ans_tk, class T = double>
+inline T ans_inf_bf(T ts) {
+	long long k = 0;
+	for (int j = 0; j < P::n_bnd; j++) {			//compile-time trip count, unrolled into straight-line compares
+		k += (dh_val(ts) >= P::bnd[j]);
+	};
+	T lts = log(fmax(ts, P::bnd[0]));		//clamped so out-of-bound columns stay finite
+	return P::form[0][k] * exp(P::form[1][k] * lts + P::form[2][k] * ts) + P::form[3][k] * lts + P::form[4][k];
+}
+
+//	corr_cf_bf:		branch-free correction factor applied by corr_fin at ts seconds after s/d
+template <class P = ans_tk, class T = double>
+inline T corr_cf_bf(T ts) {
+	return P::cf(ts);
+}
+
+//	corr_fin_bf:	branch-free corr_fin for a single time
+template <class P = ans_tk, class T = double>
+inline T corr_fin_bf(T ts, T to) {
+	return (ans_inf_bf<P, T>(ts) - ans_inf_bf<P, T>(ts + to)) * P::cf(ts);
+}
+
+//	ans_inf_skip:	ans_inf_bf for the scalar batch loops, with one transcendental per term as in ans_inf: pow for the power law, exp for
+//					the exponential and log for the log form, each only where the bin's coefficients use it
+template <class P = ans_tk>
+inline double ans_inf_skip(double ts) {
+	long long k = 0;
+	for (int j = 0; j < P::n_bnd; j++) {
+		k += (ts >= P::bnd[j]);
+	};
+	double a = P::form[0][k];
+	double b = P::form[1][k];
+	double c = P::form[2][k];
+	double d = P::form[3][k];
+	double t = (ts > P::bnd[0]) ? ts : P::bnd[0];		//compare rather than fmax, which stays a library call under value-safe floating point
+	double q = P::form[4][k];
+	if (d != 0) {
+		q += d * log(t);
+	}
+	if (a != 0) {
+		q += a * ((c == 0) ? pow(t, b) : (b == 0) ? exp(c * ts) : exp(b * log(t) + c * ts));
+	}
+	return q;
+}
+
+//	corr_cf_skip:	P::cf for the scalar batch loops, from <cform> at the region of ts; the exp and log terms are evaluated only where
+//					their coefficient is nonzero, so flat regions cost no transcendentals
+template <class P = ans_tk>
+inline double corr_cf_skip(double ts) {
+	long long r = P::region(ts);
+	double q = P::cform[4][r];
+	if (P::cform[0][r] != 0) {
+		q += P::cform[0][r] * exp(P::cform[1][r] * (ts - P::cbnd[0]));
+	}
+	if (P::cform[2][r] != 0) {
+		double arg = P::cform[3][r] * (ts - 30000000) + 1;
+		q += P::cform[2][r] * log((arg > FLT_MIN) ? arg : FLT_MIN);
+	}
+	return q;
+}
+
+#if defined(__AVX2__)
+//	--== AVX2 lanes ==--
+//	dh_log4 and dh_exp4 follow the fdlibm reductions and polynomials (under 1 ulp), so lanes agree with the scalar kernels to within
+//	a few ulp of each term. The correction reads <cform> at the lane's region and evaluates its exp and log terms only when some lane
+//	has a nonzero coefficient, so runs in regions I and III+ cost no transcendentals for cf.
+
+//	dh_log4:	natural log of four positive normal doubles
+inline __m256d dh_log4(__m256d x) {
+	const __m256i bits = _mm256_castpd_si256(x);
+	__m256d m = _mm256_castsi256_pd(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi64x(0x000FFFFFFFFFFFFFLL)), _mm256_set1_epi64x(0x3FF0000000000000LL)));
+	__m256d k = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(bits, 52), _mm256_set1_epi64x(0x4330000000000000LL))), _mm256_set1_pd(4503599627370496.0 + 1023));
+	__m256d big = _mm256_cmp_pd(m, _mm256_set1_pd(1.4142135623730951), _CMP_GT_OQ);		//m in [sqrt(1/2), sqrt(2))
+	m = _mm256_blendv_pd(m, _mm256_mul_pd(m, _mm256_set1_pd(0.5)), big);
+	k = _mm256_add_pd(k, _mm256_and_pd(big, _mm256_set1_pd(1)));
+	__m256d f = _mm256_sub_pd(m, _mm256_set1_pd(1));
+	__m256d s = _mm256_div_pd(f, _mm256_add_pd(f, _mm256_set1_pd(2)));
+	__m256d z = _mm256_mul_pd(s, s);
+	__m256d w = _mm256_mul_pd(z, z);
+	__m256d t1 = _mm256_mul_pd(w, _mm256_add_pd(_mm256_set1_pd(3.999999999940941908e-01), _mm256_mul_pd(w, _mm256_add_pd(_mm256_set1_pd(2.222219843214978396e-01), _mm256_mul_pd(w, _mm256_set1_pd(1.531383769920937332e-01))))));
+	__m256d t2 = _mm256_mul_pd(z, _mm256_add_pd(_mm256_set1_pd(6.666666666666735130e-01), _mm256_mul_pd(w, _mm256_add_pd(_mm256_set1_pd(2.857142874366239149e-01), _mm256_mul_pd(w, _mm256_add_pd(_mm256_set1_pd(1.818357216161805012e-01), _mm256_mul_pd(w, _mm256_set1_pd(1.479819860511658591e-01))))))));
+	__m256d r = _mm256_add_pd(t2, t1);
+	__m256d hfsq = _mm256_mul_pd(_mm256_set1_pd(0.5), _mm256_mul_pd(f, f));
+	__m256d lo = _mm256_add_pd(_mm256_mul_pd(s, _mm256_add_pd(hfsq, r)), _mm256_mul_pd(k, _mm256_set1_pd(1.90821492927058770002e-10)));
+	return _mm256_sub_pd(_mm256_mul_pd(k, _mm256_set1_pd(6.93147180369123816490e-01)), _mm256_sub_pd(_mm256_sub_pd(hfsq, lo), f));
+}
+
+//	dh_exp4:	exp of four doubles; results under the smallest normal double are returned as 0
+inline __m256d dh_exp4(__m256d x) {
+	__m256d under = _mm256_cmp_pd(x, _mm256_set1_pd(-708), _CMP_LT_OQ);
+	x = _mm256_min_pd(_mm256_max_pd(x, _mm256_set1_pd(-708)), _mm256_set1_pd(709));
+	__m256d k = _mm256_round_pd(_mm256_mul_pd(x, _mm256_set1_pd(1.44269504088896338700e+00)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+	__m256d hi = _mm256_sub_pd(x, _mm256_mul_pd(k, _mm256_set1_pd(6.93147180369123816490e-01)));
+	__m256d lo = _mm256_mul_pd(k, _mm256_set1_pd(1.90821492927058770002e-10));
+	__m256d r = _mm256_sub_pd(hi, lo);
+	__m256d t = _mm256_mul_pd(r, r);
+	__m256d p = _mm256_add_pd(_mm256_set1_pd(-1.65339022054652515390e-06), _mm256_mul_pd(t, _mm256_set1_pd(4.13813679705723846039e-08)));
+	p = _mm256_add_pd(_mm256_set1_pd(6.61375632143793436117e-05), _mm256_mul_pd(t, p));
+	p = _mm256_add_pd(_mm256_set1_pd(-2.77777777770155933842e-03), _mm256_mul_pd(t, p));
+	p = _mm256_add_pd(_mm256_set1_pd(1.66666666666666019037e-01), _mm256_mul_pd(t, p));
+	__m256d c = _mm256_sub_pd(r, _mm256_mul_pd(t, p));
+	__m256d rc = _mm256_div_pd(_mm256_mul_pd(r, c), _mm256_sub_pd(_mm256_set1_pd(2), c));
+	__m256d y = _mm256_sub_pd(_mm256_set1_pd(1), _mm256_sub_pd(_mm256_sub_pd(lo, rc), hi));
+	__m256i e = _mm256_slli_epi64(_mm256_castpd_si256(_mm256_add_pd(k, _mm256_set1_pd(4503599627370496.0 + 1023))), 52);		//2^k from the low bits of k + 1023 + 2^52
+	return _mm256_andnot_pd(under, _mm256_mul_pd(y, _mm256_castsi256_pd(e)));
+}
+
+//	ans_inf_4:	ans_inf_bf on four lanes
+template <class P = ans_tk>
+inline __m256d ans_inf_4(__m256d ts) {
+	__m256i k = _mm256_setzero_si256();
+	for (int j = 0; j < P::n_bnd; j++) {				//compare masks are -1, so subtracting them counts crossings
+		k = _mm256_sub_epi64(k, _mm256_castpd_si256(_mm256_cmp_pd(ts, _mm256_set1_pd(P::bnd[j]), _CMP_GE_OQ)));
+	};
+	__m256d zero = _mm256_setzero_pd();
+	__m256d a = _mm256_i64gather_pd(&P::form[0][0], k, 8);
+	__m256d b = _mm256_i64gather_pd(&P::form[1][0], k, 8);
+	__m256d d = _mm256_i64gather_pd(&P::form[3][0], k, 8);
+	__m256d q = _mm256_i64gather_pd(&P::form[4][0], k, 8);
+	__m256d lts = zero;
+	if (_mm256_movemask_pd(_mm256_cmp_pd(_mm256_or_pd(b, d), zero, _CMP_NEQ_UQ))) {		//no log where every lane's bin is a pure exponential
+		lts = dh_log4(_mm256_max_pd(ts, _mm256_set1_pd(P::bnd[0])));
+		q = _mm256_add_pd(q, _mm256_mul_pd(d, lts));
+	}
+	if (_mm256_movemask_pd(_mm256_cmp_pd(a, zero, _CMP_NEQ_UQ))) {
+		__m256d c = _mm256_i64gather_pd(&P::form[2][0], k, 8);
+		q = _mm256_add_pd(q, _mm256_mul_pd(a, dh_exp4(_mm256_add_pd(_mm256_mul_pd(b, lts), _mm256_mul_pd(c, ts)))));
+	}
+	return q;
+}
+
+//	corr_cf_4:	P::cf on four lanes, from <cform> over the regions of ans_tk::region
+template <class P = ans_tk>
+inline __m256d corr_cf_4(__m256d ts) {
+	__m256i r = _mm256_and_si256(_mm256_castpd_si256(_mm256_cmp_pd(ts, _mm256_set1_pd(P::bnd[0]), _CMP_LT_OQ)), _mm256_set1_epi64x(P::n_cbnd));
+	for (int j = 0; j < P::n_cbnd; j++) {
+		r = _mm256_sub_epi64(r, _mm256_castpd_si256(_mm256_cmp_pd(ts, _mm256_set1_pd(P::cbnd[j]), _CMP_GE_OQ)));
+	};
+	__m256d zero = _mm256_setzero_pd();
+	__m256d cp = _mm256_i64gather_pd(&P::cform[0][0], r, 8);
+	__m256d cr = _mm256_i64gather_pd(&P::cform[2][0], r, 8);
+	__m256d q_exp = zero;
+	__m256d q_log = zero;
+	if (_mm256_movemask_pd(_mm256_cmp_pd(cp, zero, _CMP_NEQ_UQ))) {
+		__m256d cq = _mm256_i64gather_pd(&P::cform[1][0], r, 8);
+		q_exp = _mm256_mul_pd(cp, dh_exp4(_mm256_mul_pd(cq, _mm256_sub_pd(ts, _mm256_set1_pd(P::cbnd[0])))));
+	}
+	if (_mm256_movemask_pd(_mm256_cmp_pd(cr, zero, _CMP_NEQ_UQ))) {
+		__m256d cs = _mm256_i64gather_pd(&P::cform[3][0], r, 8);
+		__m256d arg = _mm256_add_pd(_mm256_mul_pd(cs, _mm256_sub_pd(ts, _mm256_set1_pd(30000000))), _mm256_set1_pd(1));
+		q_log = _mm256_mul_pd(cr, dh_log4(_mm256_max_pd(arg, _mm256_set1_pd(FLT_MIN))));
+	}
+	return _mm256_add_pd(_mm256_add_pd(q_exp, q_log), _mm256_i64gather_pd(&P::cform[4][0], r, 8));
+}
+
+//	dh_count4:	in-lane out-of-range counters for the batch kernels, added into the scalar tallies once per call
+template <class P = ans_tk>
+struct dh_count4 {
+	__m256i lo;
+	__m256i hi;
+	__m256i tse_hi;
+
+	dh_count4() {
+		lo = _mm256_setzero_si256();
+		hi = _mm256_setzero_si256();
+		tse_hi = _mm256_setzero_si256();
+	}
+
+	void add(__m256d ts, __m256d tse) {
+		__m256d top = _mm256_set1_pd(P::bnd[P::n_bnd - 1]);
+		lo = _mm256_sub_epi64(lo, _mm256_castpd_si256(_mm256_cmp_pd(ts, _mm256_set1_pd(P::bnd[0]), _CMP_LT_OQ)));
+		hi = _mm256_sub_epi64(hi, _mm256_castpd_si256(_mm256_cmp_pd(ts, top, _CMP_GE_OQ)));
+		tse_hi = _mm256_sub_epi64(tse_hi, _mm256_castpd_si256(_mm256_cmp_pd(tse, top, _CMP_GE_OQ)));
+	}
+
+	static long long sum(__m256i v) {
+		long long x[4];
+		_mm256_storeu_si256((__m256i*)x, v);
+		return x[0] + x[1] + x[2] + x[3];
+	}
+
+	void get(long long& n_lo, long long& n_hi, long long& n_tse_hi) const {
+		n_lo += sum(lo);
+		n_hi += sum(hi);
+		n_tse_hi += sum(tse_hi);
+	}
+};
+#endif
+
+//	ans_inf_batch:	computes ans_inf at n timestamps ts[] into q_frac[]
+template <class P = ans_tk>
+void ans_inf_batch(const double* ts, double* q_frac, int n, dh_status* st = nullptr) {
+	long long lo = 0;
+	long long hi = 0;
+	int i = 0;
+#if defined(__AVX2__)
+	long long tse_hi = 0;
+	dh_count4<P> cnt;
+	for (; i + 4 <= n; i += 4) {
+		__m256d t = _mm256_loadu_pd(ts + i);
+		cnt.add(t, _mm256_setzero_pd());
+		_mm256_storeu_pd(q_frac + i, ans_inf_4<P>(t));
+	};
+	cnt.get(lo, hi, tse_hi);
+#endif
+	for (; i < n; i++) {
+		double t = ts[i];
+		lo += (t < P::bnd[0]);
+		hi += (t >= P::bnd[P::n_bnd - 1]);
+		q_frac[i] = ans_inf_skip<P>(t);
+	};
+	if (st != nullptr) {
+		st->tally(lo, hi, 0);
+	}
+}
+
+//	ans_fin_batch:	computes ans_fin at n timestamps ts[] for a shared operating period to into q_frac[]
+template <class P = ans_tk>
+void ans_fin_batch(const double* ts, double to, double* q_frac, int n, dh_status* st = nullptr) {
+	long long lo = 0;
+	long long hi = 0;
+	long long tse_hi = 0;
+	int i = 0;
+#if defined(__AVX2__)
+	dh_count4<P> cnt;
+	for (; i + 4 <= n; i += 4) {
+		__m256d t = _mm256_loadu_pd(ts + i);
+		__m256d te = _mm256_add_pd(t, _mm256_set1_pd(to));
+		cnt.add(t, te);
+		_mm256_storeu_pd(q_frac + i, _mm256_sub_pd(ans_inf_4<P>(t), ans_inf_4<P>(te)));
+	};
+	cnt.get(lo, hi, tse_hi);
+#endif
+	for (; i < n; i++) {
+		double t = ts[i];
+		lo += (t < P::bnd[0]);
+		hi += (t >= P::bnd[P::n_bnd - 1]);
+		tse_hi += (t + to >= P::bnd[P::n_bnd - 1]);
+		q_frac[i] = ans_inf_skip<P>(t) - ans_inf_skip<P>(t + to);
+	};
+	if (st != nullptr) {
+		st->tally(lo, hi, tse_hi);
+	}
+}
+
+//	corr_fin_batch:	computes corr_fin at n timestamps ts[] for a shared operating period to into q_frac[]
+template <class P = ans_tk>
+void corr_fin_batch(const double* ts, double to, double* q_frac, int n, dh_status* st = nullptr) {
+	long long lo = 0;
+	long long hi = 0;
+	long long tse_hi = 0;
+	int i = 0;
+#if defined(__AVX2__)
+	dh_count4<P> cnt;
+	for (; i + 4 <= n; i += 4) {
+		__m256d t = _mm256_loadu_pd(ts + i);
+		__m256d te = _mm256_add_pd(t, _mm256_set1_pd(to));
+		cnt.add(t, te);
+		_mm256_storeu_pd(q_frac + i, _mm256_mul_pd(_mm256_sub_pd(ans_inf_4<P>(t), ans_inf_4<P>(te)), corr_cf_4<P>(t)));
+	};
+	cnt.get(lo, hi, tse_hi);
+#endif
+	for (; i < n; i++) {
+		double t = ts[i];
+		lo += (t < P::bnd[0]);
+		hi += (t >= P::bnd[P::n_bnd - 1]);
+		tse_hi += (t + to >= P::bnd[P::n_bnd - 1]);
+		q_frac[i] = (ans_inf_skip<P>(t) - ans_inf_skip<P>(t + to)) * corr_cf_skip<P>(t);
+	};
+	if (st != nullptr) {
+		st->tally(lo, hi, tse_hi);
+	}
+}
+
+//	corr_fin_batch_to:	as corr_fin_batch, with a per-element operating period to[]
+template <class P = ans_tk>
+void corr_fin_batch_to(const double* ts, const double* to, double* q_frac, int n, dh_status* st = nullptr) {
+	long long lo = 0;
+	long long hi = 0;
+	long long tse_hi = 0;
+	int i = 0;
+#if defined(__AVX2__)
+	dh_count4<P> cnt;
+	for (; i + 4 <= n; i += 4) {
+		__m256d t = _mm256_loadu_pd(ts + i);
+		__m256d te = _mm256_add_pd(t, _mm256_loadu_pd(to + i));
+		cnt.add(t, te);
+		_mm256_storeu_pd(q_frac + i, _mm256_mul_pd(_mm256_sub_pd(ans_inf_4<P>(t), ans_inf_4<P>(te)), corr_cf_4<P>(t)));
+	};
+	cnt.get(lo, hi, tse_hi);
+#endif
+	for (; i < n; i++) {
+		double t = ts[i];
+		double te = t + to[i];
+		lo += (t < P::bnd[0]);
+		hi += (t >= P::bnd[P::n_bnd - 1]);
+		tse_hi += (te >= P::bnd[P::n_bnd - 1]);
+		q_frac[i] = (ans_inf_skip<P>(t) - ans_inf_skip<P>(te)) * corr_cf_skip<P>(t);
+	};
+	if (st != nullptr) {
+		st->tally(lo, hi, tse_hi);
+	}
+}
+
+//	--== float32 kernels ==--
+//	Single precision versions of the batch kernels for large member arrays, twice the SIMD lanes and half the memory of the double
+//	path. Bin indices and coefficient tables are 32-bit here to match the float lanes. The fits are good to a few percent, well above
+//	float rounding; the largest float errors come where ts and ts + to fall in different bins and the two ans_inf terms nearly
+//	cancel. dh_f32_report() measures the error against the double path. Callers accumulate sums of these results in double.
+
+//	form_f:		float copy of a policy's <form> table, made at compile time so the float kernels gather 32-bit coefficients; needs a
+//				policy with constexpr tables, so not ans_tk_var
+template <class P>
+struct form_f {
+	float v[5][P::n_bnd + 1];
+};
+
+template <class P>
+constexpr form_f<P> make_form_f() {
+	form_f<P> r = {};
+	for (int i = 0; i < 5; i++) {
+		for (int k = 0; k < P::n_bnd + 1; k++) {
+			r.v[i][k] = float(P::form[i][k]);
+		};
+	};
+	return r;
+}
+
+template <class P>
+struct tab_f {
+	static constexpr form_f<P> form = make_form_f<P>();
+};
+template <class P>
+constexpr form_f<P> tab_f<P>::form;
+
+//	ans_inf_f:		float ans_inf_bf
+template <class P = ans_tk>
+inline float ans_inf_f(float ts) {
+	const float (&f)[5][P::n_bnd + 1] = tab_f<P>::form.v;
+	int k = 0;
+	for (int j = 0; j < P::n_bnd; j++) {
+		k += (ts >= float(P::bnd[j]));
+	};
+	float lts = std::log(std::fmax(ts, float(P::bnd[0])));
+	return f[0][k] * std::exp(f[1][k] * lts + f[2][k] * ts) + f[3][k] * lts + f[4][k];
+}
+
+//	dh_expm1, dh_log1p:	select-based expm1 and log1p for the float kernels, since the library versions have no vector forms. Below
+//						1E-02 they take a series, cubic for expm1 and quartic for log1p, whose truncation error there (y^3 / 24 and
+//						x^4 / 5 relative) stays under float rounding
+template <class T>
+inline T dh_expm1(T y) {
+	T p = y * (1 + y * (T(0.5) + y * (T(1) / 6)));
+	return (std::fabs(y) < T(0.01)) ? p : std::exp(y) - 1;
+}
+
+template <class T>
+inline T dh_log1p(T x) {
+	T p = x * (1 + x * (T(-0.5) + x * (T(1) / 3 + x * T(-0.25))));
+	return (std::fabs(x) < T(0.01)) ? p : std::log(1 + x);
+}
+
+//	ans_fin_f:		float ans_fin; when ts and ts + to share a bin the difference is taken in closed form through expm1 and log1p of
+//					to / ts, which avoids the cancellation of the two terms for ts >> to
+template <class P = ans_tk>
+inline float ans_fin_f(float ts, float to) {
+	int k1 = 0;
+	int k2 = 0;
+	for (int j = 0; j < P::n_bnd; j++) {
+		k1 += (ts >= float(P::bnd[j]));
+		k2 += (ts + to >= float(P::bnd[j]));
+	};
+	const float (&f)[5][P::n_bnd + 1] = tab_f<P>::form.v;
+	float a = f[0][k1], b = f[1][k1], c = f[2][k1], d = f[3][k1];
+	float lts = std::log(std::fmax(ts, float(P::bnd[0])));
+	float g = dh_log1p(to / std::fmax(ts, float(P::bnd[0])));		//ln(ts + to) - ln(ts)
+	float q_same = -a * std::exp(b * lts + c * ts) * dh_expm1(b * g + c * to) - d * g;
+	float q_split = ans_inf_f<P>(ts) - ans_inf_f<P>(ts + to);
+	return (k1 == k2) ? q_same : q_split;
+}
+
+//	corr_fin_f:		float corr_fin_bf
+template <class P = ans_tk>
+inline float corr_fin_f(float ts, float to) {
+	return ans_fin_f<P>(ts, to) * P::cf(ts);
+}
+
+//	corr_fin_batch_f:	as corr_fin_batch, in single precision
+template <class P = ans_tk>
+void corr_fin_batch_f(const float* ts, float to, float* q_frac, int n, dh_status* st = nullptr) {
+	long long lo = 0;
+	long long hi = 0;
+	long long tse_hi = 0;
+	for (int i = 0; i < n; i++) {
+		float t = ts[i];
+		lo += (t < float(P::bnd[0]));
+		hi += (t >= float(P::bnd[P::n_bnd - 1]));
+		tse_hi += (t + to >= float(P::bnd[P::n_bnd - 1]));
+		q_frac[i] = corr_fin_f<P>(t, to);
+	};
+	if (st != nullptr) {
+		st->tally(lo, hi, tse_hi);
+	}
+}
+
+//	dh_f32_report:	compares corr_fin_f against corr_fin_bf on n log-spaced times over the fit range for operating period to; prints the
+//					largest relative error per decade of ts and returns the largest overall. Points where the double result is 0 are skipped.
+template <class P = ans_tk>
+double dh_f32_report(double to, int n = 100000) {
+	double lo = P::bnd[0];
+	double hi = std::nextafter(P::bnd[P::n_bnd - 1], 0.0);
+	int n_dec = int(ceil(log10(hi / lo)));
+	std::vector <double> err_dec(n_dec, 0);
+	double err_max = 0;
+	double err_sq = 0;
+	int n_used = 0;
+	for (int i = 0; i < n; i++) {
+		double t = lo * pow(hi / lo, double(i) / (n - 1));
+		double qd = corr_fin_bf<P>(double(float(t)), double(float(to)));		//same rounded inputs, so only the arithmetic differs
+		if (qd == 0) {
+			continue;
+		}
+		double e = fabs(corr_fin_f<P>(float(t), float(to)) / qd - 1);
+		int d = int(log10(t / lo));
+		err_dec[d < n_dec ? d : n_dec - 1] = fmax(err_dec[d < n_dec ? d : n_dec - 1], e);
+		err_max = fmax(err_max, e);
+		err_sq += e * e;
+		n_used++;
+	};
+	std::cout << "float32 accuracy, to = " << to << " s, " << n_used << " points:	max rel err = " << err_max << ", rms = " << sqrt(err_sq / fmax(n_used, 1)) << std::endl;
+	for (int d = 0; d < n_dec; d++) {
+		std::cout << "	ts in [" << lo * pow(10, d) << ", " << fmin(lo * pow(10, d + 1), hi) << "):	max rel err = " << err_dec[d] << std::endl;
+	};
+	return err_max;
+}
+
+//	--== sorted kernels ==--
+//	For non-decreasing times, such as lot members or a profile grid. The cut points where ts crosses a bin boundary, or ts + to does,
+//	are found once by binary search; each run between cuts then shares one bin for ts and one for ts + to, so its coefficients are
+//	loaded once and the run goes through a branch-free loop with no per-element bin search or gather. Out-of-range counts for
+//	<st> are read off the cut indices.
+
+//	fin_sorted:		shared body of ans_fin_sorted, corr_fin_sorted and corr_fin_sorted_f; <corr> selects whether the policy correction
+//					factor is applied. In float, runs where ts and ts + to share a bin take the ans_fin_f closed-form difference.
+template <class P, bool corr, class T = double>
+void fin_sorted(const T* ts, T to, T* q_frac, int n, dh_status* st) {
+	using std::exp;
+	using std::log;
+	using std::fmax;
+	std::vector <int> cuts = { 0, n };
+	for (int j = 0; j < P::n_bnd; j++) {
+		double b = P::bnd[j];
+		cuts.push_back(int(std::lower_bound(ts, ts + n, b) - ts));
+		cuts.push_back(int(std::lower_bound(ts, ts + n, b, [to](T t, double v) { return t + to < v; }) - ts));	//same test as the kernel, t + to >= b
+	};
+	if (st != nullptr) {
+		long long hi = n - cuts[2 * P::n_bnd];
+		long long tse_hi = n - cuts[2 * P::n_bnd + 1];
+		st->tally(cuts[2], hi, tse_hi);
+	}
+	std::sort(cuts.begin(), cuts.end());
+	cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+
+	for (int r = 0; r + 1 < int(cuts.size()); r++) {
+		int i0 = cuts[r];
+		int i1 = cuts[r + 1];
+		long long k1 = 0;
+		long long k2 = 0;
+		for (int j = 0; j < P::n_bnd; j++) {
+			k1 += (ts[i0] >= P::bnd[j]);
+			k2 += (ts[i0] + to >= P::bnd[j]);
+		};
+		T a1 = T(P::form[0][k1]), b1 = T(P::form[1][k1]), c1 = T(P::form[2][k1]), d1 = T(P::form[3][k1]), e1 = T(P::form[4][k1]);
+		T a2 = T(P::form[0][k2]), b2 = T(P::form[1][k2]), c2 = T(P::form[2][k2]), d2 = T(P::form[3][k2]), e2 = T(P::form[4][k2]);
+		T lo = T(P::bnd[0]);
+		if (sizeof(T) < sizeof(double) && k1 == k2) {
+			for (int i = i0; i < i1; i++) {
+				T t = ts[i];
+				T l1 = log(fmax(t, lo));
+				T g = dh_log1p(to / fmax(t, lo));
+				T q = -a1 * exp(b1 * l1 + c1 * t) * dh_expm1(b1 * g + c1 * to) - d1 * g;
+				q_frac[i] = corr ? q * P::cf(t) : q;
+			};
+			continue;
+		}
+		for (int i = i0; i < i1; i++) {
+			T t = ts[i];
+			T t2 = t + to;
+			T l1 = log(fmax(t, lo));
+			T l2 = log(fmax(t2, lo));
+			T q = (a1 * exp(b1 * l1 + c1 * t) + d1 * l1 + e1) - (a2 * exp(b2 * l2 + c2 * t2) + d2 * l2 + e2);
+			q_frac[i] = corr ? q * P::cf(t) : q;
+		};
+	};
+}
+
+//	ans_fin_sorted:		as ans_fin_batch, for non-decreasing ts[]
+template <class P = ans_tk>
+void ans_fin_sorted(const double* ts, double to, double* q_frac, int n, dh_status* st = nullptr) {
+	fin_sorted<P, false>(ts, to, q_frac, n, st);
+}
+
+//	corr_fin_sorted:	as corr_fin_batch, for non-decreasing ts[]
+template <class P = ans_tk>
+void corr_fin_sorted(const double* ts, double to, double* q_frac, int n, dh_status* st = nullptr) {
+	fin_sorted<P, true>(ts, to, q_frac, n, st);
+}
+
+//	corr_fin_sorted_f:	as corr_fin_batch_f, for non-decreasing ts[]
+template <class P = ans_tk>
+void corr_fin_sorted_f(const float* ts, float to, float* q_frac, int n, dh_status* st = nullptr) {
+	fin_sorted<P, true, float>(ts, to, q_frac, n, st);
+}
+
+//	ans_inf_sorted:		as ans_inf_batch, for non-decreasing ts[]
+template <class P = ans_tk>
+void ans_inf_sorted(const double* ts, double* q_frac, int n, dh_status* st = nullptr) {
+	std::vector <int> cuts = { 0, n };
+	for (int j = 0; j < P::n_bnd; j++) {
+		cuts.push_back(int(std::lower_bound(ts, ts + n, P::bnd[j]) - ts));
+	};
+	if (st != nullptr) {
+		st->tally(cuts[2], n - cuts[P::n_bnd + 1], 0);
+	}
+	std::sort(cuts.begin(), cuts.end());
+	cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+
+	for (int r = 0; r + 1 < int(cuts.size()); r++) {
+		int i0 = cuts[r];
+		int i1 = cuts[r + 1];
+		long long k = 0;
+		for (int j = 0; j < P::n_bnd; j++) {
+			k += (ts[i0] >= P::bnd[j]);
+		};
+		double a = P::form[0][k], b = P::form[1][k], c = P::form[2][k], d = P::form[3][k], e = P::form[4][k];
+		double lo = P::bnd[0];
+		for (int i = i0; i < i1; i++) {
+			double t = ts[i];
+			double l = log(fmax(t, lo));
+			q_frac[i] = a * exp(b * l + c * t) + d * l + e;
+		};
+	};
+}
+
+//	--== summation ==--
+
+//	gl8_x, gl8_w:	positive nodes and weights of 8-point Gauss-Legendre quadrature on [-1, 1]
+const double gl8_x[4] = { 0.1834346424956498, 0.5255324099163290, 0.7966664774136267, 0.9602898564975363 };
+const double gl8_w[4] = { 0.3626837833783620, 0.3137066458778873, 0.2223810344533745, 0.1012285362903763 };
+
+//	gl8_log:		integral of f over [a, b] (s), by composite 8-point Gauss-Legendre in ln(ts) over m panels
+template <class F>
+double gl8_log(F f, double a, double b, int m) {
+	double la = log(a);
+	double w = (log(b) - la) / m;
+	double q = 0;
+	for (int j = 0; j < m; j++) {
+		double c = la + (j + 0.5) * w;
+		for (int k = 0; k < 4; k++) {
+			double t_lo = exp(c - 0.5 * w * gl8_x[k]);
+			double t_hi = exp(c + 0.5 * w * gl8_x[k]);
+			q += gl8_w[k] * (t_lo * f(t_lo) + t_hi * f(t_hi));		//dts = ts*d(ln ts)
+		};
+	};
+	return q * 0.5 * w;
+}
+
+//	corr_fin_int:	integral of corr_fin over [a, b] (s) on m panels of gl8_log; [a, b] must not contain a kink of corr_fin
+template <class P = ans_tk>
+double corr_fin_int(double a, double b, double to, int m) {
+	return gl8_log([to](double t) { return corr_fin_bf<P>(t, to); }, a, b, m);
+}
+
+//	em_sum:			sum of f over the n uniformly spaced times ts = t0 + i*h, i = 0..n-1, at a cost independent of n. The grid is cut at
+//					kinks[] and each smooth stretch is summed by Euler-Maclaurin in Gregory form: the integral over the stretch
+//					(f_int(a, b, m) on m panels) divided by h, plus end corrections from one-sided differences of the end samples
+//					through third order. Stretches under 16 points, and grid points within 64 steps of ts = 0, are summed directly.
+//					<err> receives an estimate of the absolute error: the size of the omitted fourth-order terms plus the change in
+//					each integral between m and 2m panels
+template <class F, class I>
+double em_sum(double t0, double h, long long n, const std::vector <double>& kinks, F f, I f_int, double& err) {
+	err = 0;
+	if (n <= 0) {
+		return 0;
+	}
+
+	std::vector <long long> cuts = { 0, n };
+	for (int k = 0; k < int(kinks.size()); k++) {
+		double c = ceil((kinks[k] - t0) / h);					//first grid index on or past the kink
+		if (0 < c && c < double(n)) {
+			cuts.push_back((long long)c);
+		}
+	};
+	std::sort(cuts.begin(), cuts.end());
+	cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+
+	double q_sum = 0;
+	for (int s = 0; s + 1 < int(cuts.size()); s++) {
+		long long i_lo = cuts[s];
+		long long i_hi = cuts[s + 1] - 1;						//last grid index in the stretch
+		double i_em = ceil((64 * h - t0) / h);					//grid points younger than 64 steps are summed directly, keeping h/ts small enough for the series
+		if (i_em > i_lo) {
+			long long i_dir = (i_em > double(i_hi + 1)) ? i_hi + 1 : (long long)i_em;
+			for (long long i = i_lo; i < i_dir; i++) {
+				q_sum += f(t0 + i * h);
+			};
+			i_lo = i_dir;
+		}
+		if (i_hi - i_lo < 15) {
+			for (long long i = i_lo; i <= i_hi; i++) {
+				q_sum += f(t0 + i * h);
+			};
+			continue;
+		}
+		double a = t0 + i_lo * h;
+		double b = t0 + i_hi * h;
+
+		double f0[5];											//first and last five samples of the stretch
+		double fn[5];
+		for (int j = 0; j < 5; j++) {
+			f0[j] = f(t0 + (i_lo + j) * h);
+			fn[j] = f(t0 + (i_hi - j) * h);
+		};
+		double d0[4];											//forward differences at the start, backward differences at the end
+		double dn[4];
+		for (int r = 0; r < 4; r++) {
+			for (int j = 0; j < 4 - r; j++) {
+				f0[j] = f0[j + 1] - f0[j];
+				fn[j] = fn[j] - fn[j + 1];
+			};
+			d0[r] = f0[0];
+			dn[r] = fn[0];
+		};
+
+		int m = int(ceil((log(b) - log(a)) / 0.5));			//panels of half a unit in ln(ts)
+		double i_m = f_int(a, b, m);
+		double i_2m = f_int(a, b, 2 * m);
+		double f_a = f(a);
+		double f_b = f(b);
+
+		q_sum += i_2m / h + 0.5 * (f_a + f_b) + (dn[0] - d0[0]) / 12 + (dn[1] + d0[1]) / 24 + 19 * (dn[2] - d0[2]) / 720;
+		err += fabs(3 * (dn[3] + d0[3]) / 160) + fabs(i_2m - i_m) / h;
+	};
+	return q_sum;
+}
+
+//	corr_fin_sum:	sum of corr_fin over the n uniformly spaced times ts = t0 + i*h, i = 0..n-1, by em_sum cut at the kinks of corr_fin
+template <class P = ans_tk>
+double corr_fin_sum(double t0, double h, long long n, double to, double& err) {
+	std::vector <double> kinks;
+	for (int k = 0; k < P::n_bnd; k++) {
+		kinks.push_back(P::bnd[k]);
+		kinks.push_back(P::bnd[k] - to);
+	};
+	for (int k = 0; k < P::n_cbnd; k++) {
+		kinks.push_back(P::cbnd[k]);
+	};
+	return em_sum(t0, h, n, kinks, [to](double t) { return corr_fin_bf<P>(t, to); }, [to](double a, double b, int m) { return corr_fin_int<P>(a, b, to, m); }, err);
+}
+
+//	--== cumulative energy ==--
+//	Decay energy released between cooling times t1 and t2, as a fraction of full power times seconds (multiply by qo in kW for kJ).
+//	Each bin of the fit is integrated through its antiderivative: D*(ts*ln(ts) - ts) + E*ts for the log form, A*ts^(B+1)/(B+1) for the
+//	power law and A*exp(C*ts)/C for the exponential, so a query costs a few terms per bin crossed.
+
+//	ans_int:	antiderivative of bin k of the policy fit at ts
+template <class P = ans_tk>
+double ans_int(double ts, long long k) {
+	double a = P::form[0][k], b = P::form[1][k], c = P::form[2][k], d = P::form[3][k], e = P::form[4][k];
+	double g = 0;
+	if (a != 0) {
+		if (c != 0) {
+			g += a * exp(c * ts) / c;
+		}
+		else if (b == -1) {
+			g += a * log(ts);
+		}
+		else {
+			g += a * pow(ts, b + 1) / (b + 1);
+		}
+	}
+	if (d != 0 || e != 0) {
+		g += d * (ts * log(ts) - ts) + e * ts;
+	}
+	return g;
+}
+
+//	energy_inf:		integral of ans_inf over [t1, t2]
+template <class P = ans_tk>
+double energy_inf(double t1, double t2) {
+	double q_int = 0;
+	for (long long k = 1; k < P::n_bnd; k++) {				//bins 0 and n_bnd lie out of bounds and integrate to 0
+		double a = fmax(t1, P::bnd[k - 1]);
+		double b = fmin(t2, P::bnd[k]);
+		if (a < b) {
+			q_int += ans_int<P>(b, k) - ans_int<P>(a, k);
+		}
+	};
+	return q_int;
+}
+
+//	energy_fin:		integral of ans_fin over [t1, t2] for operating period to
+template <class P = ans_tk>
+double energy_fin(double t1, double t2, double to) {
+	return energy_inf<P>(t1, t2) - energy_inf<P>(t1 + to, t2 + to);
+}
+
+//	energy_corr:	integral of corr_fin over [t1, t2] for operating period to. Split at the kinks of corr_fin; stretches in a region where
+//					the correction is constant are closed form, the remainder (regions II and III of ans_tk) use corr_fin_int
+template <class P = ans_tk>
+double energy_corr(double t1, double t2, double to) {
+	const int n_cut = 2 + 2 * P::n_bnd + P::n_cbnd;
+	double cuts[n_cut] = { t1, t2 };						//fixed size, kept on the stack for per-element calls
+	for (int k = 0; k < P::n_bnd; k++) {
+		cuts[2 + 2 * k] = P::bnd[k];
+		cuts[3 + 2 * k] = P::bnd[k] - to;
+	};
+	for (int k = 0; k < P::n_cbnd; k++) {
+		cuts[2 + 2 * P::n_bnd + k] = P::cbnd[k];
+	};
+	std::sort(cuts, cuts + n_cut);
+	double q_int = 0;
+	for (int j = 0; j + 1 < n_cut; j++) {
+		double a = fmax(cuts[j], t1);
+		double b = fmin(cuts[j + 1], t2);
+		if (!(a < b)) {
+			continue;
+		}
+		double mid = 0.5 * (a + b);
+		if (P::cf_flat[P::region(mid)]) {
+			q_int += P::cf(mid) * energy_fin<P>(a, b, to);
+		}
+		else {
+			q_int += corr_fin_int<P>(a, b, to, int(ceil(log(b / a) / 0.5)));
+		}
+	};
+	return q_int;
+}
+
+//	energy_sum:		sum of energy_corr over [ts + t1, ts + t2] for the n uniformly spaced times ts = t0 + i*h, i = 0..n-1, by em_sum cut
+//					where ts + t1 or ts + t2 meets a kink of corr_fin; the decay energy of a lot in O(segments) rather than O(members)
+template <class P = ans_tk>
+double energy_sum(double t0, double h, long long n, double t1, double t2, double to, double& err) {
+	std::vector <double> kinks;
+	for (int k = 0; k < P::n_bnd; k++) {
+		kinks.push_back(P::bnd[k] - t1);
+		kinks.push_back(P::bnd[k] - t2);
+		kinks.push_back(P::bnd[k] - to - t1);
+		kinks.push_back(P::bnd[k] - to - t2);
+	};
+	for (int k = 0; k < P::n_cbnd; k++) {
+		kinks.push_back(P::cbnd[k] - t1);
+		kinks.push_back(P::cbnd[k] - t2);
+	};
+	auto f = [t1, t2, to](double t) { return energy_corr<P>(t + t1, t + t2, to); };
+	return em_sum(t0, h, n, kinks, f, [f](double a, double b, int m) { return gl8_log(f, a, b, m); }, err);
+}
+
+//	--== inverse ==--
+//	Cooling time at which decay heat falls to a target fraction of full power and stays below it through the rest of the fit range.
+//	Returns the lower bound of the fit if the target is never exceeded, and HUGE_VAL if it is still exceeded at the upper bound.
+
+//	ans_bin:	bin k of the policy fit evaluated at ts, without the bin search
+template <class P = ans_tk>
+double ans_bin(double ts, long long k) {
+	double l = log(ts);
+	return P::form[0][k] * exp(P::form[1][k] * l + P::form[2][k] * ts) + P::form[3][k] * l + P::form[4][k];
+}
+
+//	ans_bin_inv:	closed-form inverse of bin k of the policy fit
+template <class P = ans_tk>
+double ans_bin_inv(double q_frac, long long k) {
+	double a = P::form[0][k], b = P::form[1][k], c = P::form[2][k], d = P::form[3][k], e = P::form[4][k];
+	if (a == 0) {
+		return exp((q_frac - e) / d);			//log form
+	}
+	else if (c != 0) {
+		return log(q_frac / a) / c;				//exponential
+	}
+	return pow(q_frac / a, 1 / b);				//power law
+}
+
+//	ans_inf_inv:	closed-form inverse of ans_inf
+template <class P = ans_tk>
+double ans_inf_inv(double q_frac) {
+	for (long long k = P::n_bnd - 1; k >= 1; k--) {			//latest bin first; bins are decreasing, with jumps at the boundaries
+		double v_lo = ans_bin<P>(P::bnd[k - 1], k);
+		double v_hi = ans_bin<P>(P::bnd[k], k);
+		if (v_hi >= q_frac) {
+			return (k == P::n_bnd - 1) ? HUGE_VAL : P::bnd[k];
+		}
+		if (v_lo >= q_frac) {
+			return fmin(fmax(ans_bin_inv<P>(q_frac, k), P::bnd[k - 1]), P::bnd[k]);
+		}
+	};
+	return P::bnd[0];
+}
+
+//	dh_root:	safeguarded root of g on [xa, xb] with g(xa) >= 0 > g(xb), starting from guess x0; Illinois false position steps that fall
+//				outside the bracket or fail to shrink it by half are replaced by bisection
+template <class G>
+double dh_root(G g, double xa, double xb, double ga, double gb, double x0) {
+	double x = (xa < x0 && x0 < xb) ? x0 : 0.5 * (xa + xb);
+	int side = 0;
+	for (int it = 0; it < 100 && xb - xa > 1e-13 * fmax(1, fabs(xa)); it++) {
+		double gx = g(x);
+		double w = xb - xa;
+		if (gx >= 0) {
+			xa = x;
+			ga = gx;
+			if (side == -1) {
+				gb *= 0.5;
+			}
+			side = -1;
+		}
+		else {
+			xb = x;
+			gb = gx;
+			if (side == 1) {
+				ga *= 0.5;
+			}
+			side = 1;
+		}
+		x = xa + (xb - xa) * ga / (ga - gb);
+		if (!(xa < x && x < xb) || xb - xa > 0.5 * w) {
+			x = 0.5 * (xa + xb);
+		}
+	};
+	return 0.5 * (xa + xb);
+}
+
+//	corr_inv_t:		inverse of corr_fin for one operating period. The kinks of corr_fin and its values either side of each are found once,
+//					so each target costs a scan over the pieces and a dh_root solve in ln(ts) seeded by ans_bin_inv
+template <class P>
+struct corr_inv_t {
+	double to;						//length of operation prior to s/d (s)
+	std::vector <double> edge;		//piece boundaries (s)
+	std::vector <double> v_lo;		//corr_fin at the start of each piece
+	std::vector <double> v_hi;		//corr_fin approaching the end of each piece
+
+	corr_inv_t() = default;
+	corr_inv_t(double toi) {
+		to = toi;
+		edge = { P::bnd[0], P::bnd[P::n_bnd - 1] };
+		for (int k = 0; k < P::n_bnd; k++) {
+			edge.push_back(P::bnd[k] - to);
+		};
+		for (int k = 1; k < P::n_bnd - 1; k++) {
+			edge.push_back(P::bnd[k]);
+		};
+		for (int k = 0; k < P::n_cbnd; k++) {
+			edge.push_back(P::cbnd[k]);
+		};
+		std::sort(edge.begin(), edge.end());
+		edge.erase(std::remove_if(edge.begin(), edge.end(), [](double e) { return e < P::bnd[0] || e > P::bnd[P::n_bnd - 1]; }), edge.end());
+		edge.erase(std::unique(edge.begin(), edge.end()), edge.end());
+		for (int j = 0; j + 1 < int(edge.size()); j++) {
+			v_lo.push_back(corr_fin_bf<P>(edge[j], to));
+			v_hi.push_back(corr_fin_bf<P>(std::nextafter(edge[j + 1], 0.0), to));
+		};
+	}
+
+	//	solve():	cooling time at which corr_fin falls below q_frac for good
+	double solve(double q_frac) const {
+		for (int j = int(v_lo.size()) - 1; j >= 0; j--) {
+			if (v_hi[j] >= q_frac) {
+				return (j == int(v_lo.size()) - 1) ? HUGE_VAL : edge[j + 1];
+			}
+			if (v_lo[j] >= q_frac) {
+				double mid = sqrt(edge[j] * edge[j + 1]);
+				long long k = 0;
+				for (int b = 0; b < P::n_bnd; b++) {
+					k += (mid >= P::bnd[b]);
+				};
+				double seed = ans_bin_inv<P>(q_frac / P::cf(mid) + ans_inf_bf<P>(mid + to), k);		//inverts the ts term with the ts + to term frozen
+				double t_to = to;
+				auto g = [q_frac, t_to](double x) { return corr_fin_bf<P>(exp(x), t_to) - q_frac; };
+				return exp(dh_root(g, log(edge[j]), log(edge[j + 1]), v_lo[j] - q_frac, v_hi[j] - q_frac, log(seed)));
+			}
+		};
+		return edge[0];
+	}
+
+	//	solve_batch():	solves n targets q_frac[] into ts[]
+	void solve_batch(const double* q_frac, double* ts, int n) const {
+		for (int i = 0; i < n; i++) {
+			ts[i] = solve(q_frac[i]);
+		};
+	}
+
+	//	solve_kw():	cooling time at which an element operated at qo falls below q_target for good, in the units of qo
+	double solve_kw(double q_target, double qo) const {
+		return solve(q_target / qo);
+	}
+
+	//	solve_batch_kw():	solves n targets q_target[] for elements of per-element power qo[] into ts[]
+	void solve_batch_kw(const double* q_target, const double* qo, double* ts, int n) const {
+		for (int i = 0; i < n; i++) {
+			ts[i] = solve(q_target[i] / qo[i]);
+		};
+	}
+};
+
+typedef corr_inv_t<ans_tk> corr_inv;
+
+//	corr_fin_inv:	cooling time at which corr_fin for operating period to falls below q_frac for good
+template <class P = ans_tk>
+double corr_fin_inv(double q_frac, double to) {
+	return corr_inv_t<P>(to).solve(q_frac);
+}
+
+//	corr_fin_inv:	cooling time at which an element operated at qo for to falls below q_target (in the units of qo) for good
+template <class P = ans_tk>
+double corr_fin_inv(double q_target, double to, double qo) {
+	return corr_inv_t<P>(to).solve_kw(q_target, qo);
+}
+
+//	--== surrogates ==--
+
+//	corr_cheb:	piecewise-Chebyshev surrogate of corr_fin for one operating period <to>, built once and evaluated without transcendentals
+//				beyond one log per time. Pieces are laid out in ln(ts) between the kinks of corr_fin (bnd, bnd - to and cbnd of the policy)
+//				and halved until each reproduces corr_fin to within tol/2 relative error on a check grid four times denser than its nodes;
+//				the factor of two covers error peaks between check points, so <tol> is the stated bound and <err_max> the measured one
+template <class P>
+struct corr_cheb_t {
+	double to;					//length of operation prior to s/d (s)
+	double tol;					//requested max relative error vs corr_fin
+	double err_max;				//max relative error vs corr_fin measured on the check grid during build
+	double ts_min;				//lower bound of tabulated times (s); times outside [ts_min, ts_max) fall back to the exact kernel
+	double ts_max;				//upper bound of tabulated times (s)
+	int deg;					//polynomial degree of each piece
+	std::vector <double> bnd;		//piece boundaries in ln(ts); piece p spans [bnd[p], bnd[p+1])
+	std::vector <double> hi;		//upper boundary of each piece, with the last left open so lookups never step past it
+	std::vector <double> mid;		//midpoint of each piece in ln(ts)
+	std::vector <double> ihw;		//inverse half-width of each piece in ln(ts)
+	std::vector <double> coef;		//chebyshev coefficients, deg + 1 per piece
+	std::vector <long long> cell;	//piece containing the start of each uniform ln(ts) lookup cell
+	double cell_w;					//width of a lookup cell in ln(ts)
+	bool cell_1;					//true if no cell holds more than one piece boundary, so a lookup needs at most one step
+
+	corr_cheb_t() = default;
+	corr_cheb_t(double& toi, double tol_i, int deg_i = 8, double ts_lo = 1.5, double ts_hi = 10000000000) {
+		build(toi, tol_i, deg_i, ts_lo, ts_hi);
+	}
+
+	//	build():	tabulates corr_fin for operating period toi; returns err_max
+	double build(double& toi, double tol_i, int deg_i = 8, double ts_lo = 1.5, double ts_hi = 10000000000) {
+		to = toi;
+		tol = tol_i;
+		deg = deg_i;
+		ts_min = ts_lo;
+		ts_max = ts_hi;
+		err_max = 0;
+		bnd.clear();
+		coef.clear();
+
+		std::vector <double> kinks = { ts_min, ts_max };			//breakpoints where corr_fin or its slope jumps
+		for (int k = 0; k < P::n_bnd; k++) {
+			kinks.push_back(P::bnd[k]);
+			kinks.push_back(P::bnd[k] - to);
+		};
+		for (int k = 0; k < P::n_cbnd; k++) {
+			kinks.push_back(P::cbnd[k]);
+		};
+		std::vector <double> edges;
+		for (int k = 0; k < int(kinks.size()); k++) {
+			if (ts_min <= kinks[k] && kinks[k] <= ts_max) {
+				edges.push_back(log(kinks[k]));
+			}
+		};
+		std::sort(edges.begin(), edges.end());
+		edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+		bnd.push_back(edges[0]);
+		for (int k = 0; k + 1 < int(edges.size()); k++) {
+			fit(edges[k], edges[k + 1]);
+		};
+
+		int n_pc = int(bnd.size()) - 1;
+		hi.assign(n_pc, HUGE_VAL);
+		mid.resize(n_pc);
+		ihw.resize(n_pc);
+		double w_min = bnd[n_pc] - bnd[0];
+		for (int p = 0; p < n_pc; p++) {
+			if (p + 1 < n_pc) {
+				hi[p] = bnd[p + 1];
+			}
+			mid[p] = 0.5 * (bnd[p] + bnd[p + 1]);
+			ihw[p] = 2 / (bnd[p + 1] - bnd[p]);
+			w_min = fmin(w_min, bnd[p + 1] - bnd[p]);
+		};
+
+		int n_cell = int(fmin(65536, fmax(64, ceil((bnd[n_pc] - bnd[0]) / w_min))));	//sized to the narrowest piece where possible
+		cell_w = (bnd[n_pc] - bnd[0]) / n_cell;
+		cell.assign(n_cell + 1, 0);
+		cell_1 = true;
+		long long p = 0;
+		for (int c = 0; c <= n_cell; c++) {
+			double xc = bnd[0] + c * cell_w;
+			while (hi[p] <= xc) {
+				p++;
+			};
+			cell[c] = p;
+			int steps = 0;
+			for (long long q = p; hi[q] <= xc + cell_w; q++) {			//counts boundaries crossed within the cell
+				steps++;
+			};
+			cell_1 = cell_1 && steps < 2;
+		};
+		return err_max;
+	}
+
+	//	eval():		evaluates the surrogate at ts seconds after s/d
+	double eval(double ts) const {
+		if (!(ts_min <= ts && ts < ts_max)) {
+			return corr_fin_bf<P>(ts, to);
+		}
+		double x = log(ts);
+		long long p = cell[(long long)((x - bnd[0]) / cell_w)];
+		while (x >= hi[p]) {
+			p++;
+		};
+		return clenshaw(&coef[p * (deg + 1)], (x - mid[p]) * ihw[p]);
+	}
+
+	//	eval_batch():	evaluates the surrogate at n timestamps ts[] into q_frac[]; q_frac may alias ts. Works through blocks of
+	//					times so the piece lookup and each Clenshaw step run as branch-free loops across the block
+	void eval_batch(const double* ts, double* q_frac, int n) const {
+		if (!cell_1) {
+			for (int i = 0; i < n; i++) {
+				q_frac[i] = eval(ts[i]);
+			};
+			return;
+		}
+		const int blk = 256;
+		double u[blk];
+		double b1[blk];
+		double b2[blk];
+		long long base[blk];
+		double x_lo = bnd[0];
+		double x_hi = bnd.back();
+		for (int i0 = 0; i0 < n; i0 += blk) {
+			int m = (n - i0 < blk) ? n - i0 : blk;
+			const double* t = ts + i0;
+			double* q = q_frac + i0;
+			for (int i = 0; i < m; i++) {
+				double x = fmin(fmax(log(t[i]), x_lo), x_hi);
+				long long p = cell[(long long)((x - x_lo) / cell_w)];
+				p += (x >= hi[p]);
+				u[i] = (x - mid[p]) * ihw[p];
+				base[i] = p * (deg + 1);
+				b1[i] = 0;
+				b2[i] = 0;
+			};
+			for (int k = deg; k > 0; k--) {
+				for (int i = 0; i < m; i++) {
+					double b0 = 2 * u[i] * b1[i] - b2[i] + coef[base[i] + k];
+					b2[i] = b1[i];
+					b1[i] = b0;
+				};
+			};
+			for (int i = 0; i < m; i++) {
+				double ti = t[i];
+				double qs = u[i] * b1[i] - b2[i] + coef[base[i]];
+				q[i] = (ts_min <= ti && ti < ts_max) ? qs : corr_fin_bf<P>(ti, to);
+			};
+		};
+	}
+
+	//	clenshaw():	sums a chebyshev series c[0..deg] at u in [-1, 1]
+	double clenshaw(const double* c, double u) const {
+		double b1 = 0;
+		double b2 = 0;
+		for (int k = deg; k > 0; k--) {
+			double b0 = 2 * u * b1 - b2 + c[k];
+			b2 = b1;
+			b1 = b0;
+		};
+		return u * b1 - b2 + c[0];
+	}
+
+	//	fit():		fits [a, b) in ln(ts), halving the interval until the check grid meets tol/2
+	void fit(double a, double b) {
+		int n = deg + 1;
+		std::vector <double> ts(n);
+		std::vector <double> q(n);
+		std::vector <double> c(n, 0);
+		for (int j = 0; j < n; j++) {						//chebyshev-gauss nodes, mapped from [-1, 1] to [a, b)
+			ts[j] = exp(0.5 * (a + b) + 0.5 * (b - a) * cos(dh_pi * (j + 0.5) / n));
+		};
+		corr_fin_batch<P>(ts.data(), to, q.data(), n);
+		for (int k = 0; k < n; k++) {
+			for (int j = 0; j < n; j++) {
+				c[k] += q[j] * cos(dh_pi * k * (j + 0.5) / n);
+			};
+			c[k] *= (k == 0 ? 1.0 : 2.0) / n;
+		};
+
+		int m = 4 * n;
+		std::vector <double> tc(m);
+		std::vector <double> qc(m);
+		for (int j = 0; j < m; j++) {						//uniform check grid strictly inside the piece
+			tc[j] = a + (b - a) * (j + 0.5) / m;
+		};
+		double err = 0;
+		for (int j = 0; j < m; j++) {
+			qc[j] = exp(tc[j]);
+		};
+		corr_fin_batch<P>(qc.data(), to, qc.data(), m);
+		for (int j = 0; j < m; j++) {
+			double qs = clenshaw(c.data(), 2 * (j + 0.5) / m - 1);
+			if (qc[j] != 0) {
+				err = fmax(err, fabs(qs / qc[j] - 1));
+			}
+		};
+
+		if (err > 0.5 * tol && b - a > 0.0001) {					//splits unless the piece has collapsed below 1E-04 in ln(ts)
+			fit(a, 0.5 * (a + b));
+			fit(0.5 * (a + b), b);
+			return;
+		}
+		err_max = fmax(err_max, err);
+		coef.insert(coef.end(), c.begin(), c.end());
+		bnd.push_back(b);
+	}
+};
+
+typedef corr_cheb_t<ans_tk> corr_cheb;
+
+//	--== multi-group backend ==--
+
+//	dh_groups:	decay heat as a sum of exponential groups, P/P0 = sum_i a_i*exp(-l_i*ts)*(1 - exp(-l_i*to)) with a_i = f*alpha_i/lambda_i/Q,
+//				pooled over each fissioning nuclide added with its fission fraction f. Exponentials make sums over a uniformly spaced
+//				series of elements geometric, so a whole lot is summed in O(groups) by lot_sum()
+struct dh_groups {
+	std::vector <double> amp;		//group amplitude a_i, fraction of full power after infinite operation at ts = 0
+	std::vector <double> lam;		//group decay constant l_i (1/s)
+
+	dh_groups() = default;
+	dh_groups(const double (*tab)[2], int n) {
+		add(tab, n, 1);
+	}
+
+	//	add():		appends the n groups of a {alpha, lambda} table for a nuclide contributing fraction f of fissions
+	void add(const double (*tab)[2], int n, double f) {
+		for (int i = 0; i < n; i++) {
+			amp.push_back(f * tab[i][0] / tab[i][1] / q_fission);
+			lam.push_back(tab[i][1]);
+		};
+	}
+
+	//	frac_inf():	decay heat fraction of full power after infinitely long operation at ts seconds after s/d
+	double frac_inf(double ts) const {
+		double q_frac = 0;
+		for (int i = 0; i < int(amp.size()); i++) {
+			q_frac += amp[i] * exp(-lam[i] * ts);
+		};
+		return q_frac;
+	}
+
+	//	frac_fin():	decay heat fraction of full power after finite operating period to at ts seconds after s/d
+	double frac_fin(double ts, double to) const {
+		double q_frac = 0;
+		for (int i = 0; i < int(amp.size()); i++) {
+			q_frac -= amp[i] * exp(-lam[i] * ts) * expm1(-lam[i] * to);
+		};
+		return q_frac;
+	}
+
+	//	lot_sum():	sum of frac_fin over n elements at ts = t0, t0 + dt, ..., t0 + (n - 1)*dt, as a geometric series per group
+	double lot_sum(double t0, double dt, int n, double to) const {
+		double q_sum = 0;
+		for (int i = 0; i < int(amp.size()); i++) {
+			double l = lam[i];
+			double series = (dt > 0) ? expm1(-l * dt * n) / expm1(-l * dt) : n;	//(1 - r^n) / (1 - r), r = exp(-l*dt)
+			q_sum -= amp[i] * exp(-l * t0) * expm1(-l * to) * series;
+		};
+		return q_sum;
+	}
+};
+
 #endif
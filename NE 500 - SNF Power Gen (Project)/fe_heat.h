@@ -9,63 +9,291 @@
 #define _FE_HEAT_
 
 #include <vector>
+#include <algorithm>
+#include <functional>
 
 #include "decay_heat.h"
+#include "pwr_history.h"
+#include "parallel.h"
 #include "csvwrite.h"
 
 //	--== utilities ==--
 
+//	Reducers for lot::gen_stream. Member powers arrive in blocks through add(q, n, i0), where q[0..n) are the powers (kW) of members
+//	i0 .. i0 + n - 1, and are folded into a summary without being stored. Any type with this add() can be passed.
+
+const int stream_block = 1024;		//members evaluated per block in gen_stream; the block stays in L1
+
+//	red_sum:	total power
+struct red_sum {
+	double sum = 0;
+
+	void add(const double* q, int n, long long /*i0*/) {
+		for (int i = 0; i < n; i++) {
+			sum += q[i];
+		};
+	}
+};
+
+//	red_max:	hottest member and its index
+struct red_max {
+	double max = -HUGE_VAL;
+	long long at = -1;
+
+	void add(const double* q, int n, long long i0) {
+		for (int i = 0; i < n; i++) {
+			if (q[i] > max) {
+				max = q[i];
+				at = i0 + i;
+			}
+		};
+	}
+};
+
+//	red_hist:	member count per power bin, nb equal bins over [lo, hi); values outside fall in the end bins
+struct red_hist {
+	double lo;
+	double hi;
+	vector <long long> counts;
+
+	red_hist(double loi, double hii, int nb) {
+		lo = loi;
+		hi = hii;
+		counts.assign(nb, 0);
+	}
+
+	void add(const double* q, int n, long long /*i0*/) {
+		int nb = int(counts.size());
+		double scale = nb / (hi - lo);
+		for (int i = 0; i < n; i++) {
+			int b = int(fmin(fmax((q[i] - lo) * scale, 0), nb - 1));
+			counts[b]++;
+		};
+	}
+};
+
+//	red_topk:	the k hottest members as {power, index}, kept in a min-heap; sorted() returns them hottest first
+struct red_topk {
+	int k;
+	vector <std::pair<double, long long>> heap;
+
+	red_topk(int ki) {
+		k = ki;
+		heap.reserve(k);
+	}
+
+	void add(const double* q, int n, long long i0) {
+		auto cmp = std::greater <std::pair<double, long long>>();
+		for (int i = 0; i < n; i++) {
+			if (int(heap.size()) < k) {
+				heap.push_back({ q[i], i0 + i });
+				std::push_heap(heap.begin(), heap.end(), cmp);
+			}
+			else if (k > 0 && q[i] > heap.front().first) {
+				std::pop_heap(heap.begin(), heap.end(), cmp);
+				heap.back() = { q[i], i0 + i };
+				std::push_heap(heap.begin(), heap.end(), cmp);
+			}
+		};
+	}
+
+	vector <std::pair<double, long long>> sorted() const {
+		vector <std::pair<double, long long>> out = heap;
+		std::sort(out.begin(), out.end(), std::greater <std::pair<double, long long>>());
+		return out;
+	}
+};
+
 //	--== structs ==--
 
-//	dh_profile:	stores decay heat data computed at the inputed timesteps, with support for .csv export
-struct dh_profile {
+//	dh_profile:	stores decay heat data computed at the inputed timesteps, with support for .csv export; templated on a correlation policy from decay_heat.h
+template <class P>
+struct dh_profile_t {
 	vector <double> times;		//timestamps composing the profile (s)
 	vector <double> powers;		//power or power fraction at corresponding timestamp
 	double to;					//length of operation prior to s/d (s)
 	double qo;					//operating power prior to s/d; default set to 1, computed power will be output as fraction of power
+	dh_status status;			//out-of-range tally from the last gen_ans/gen_corr
 
-	dh_profile() = default;
-	dh_profile(vector <double> spread) {
-		times = spread;
+	dh_profile_t() = default;
+	dh_profile_t(vector <double> spread) {
+		times = std::move(spread);
 		qo = 1;
 	}
-	dh_profile(vector <double> spread, double &t) {
-		times = spread;
+	dh_profile_t(vector <double> spread, double &t) {
+		times = std::move(spread);
 		to = t;
 		qo = 1;
 	}
-	dh_profile(vector <double> spread, double& t, double &q) {
-		times = spread;
+	dh_profile_t(vector <double> spread, double& t, double &q) {
+		times = std::move(spread);
 		to = t;
 		qo = q;
 	}
 
-	//	gen_ans:	generates <powers> at each timestamp using the uncorrected ans approximation from decay_heat.h
+	//	gen_ans:	generates <powers> at each timestamp using the uncorrected ans approximation from decay_heat.h; overwrites any previous result in place
 	void gen_ans() {
+		int n = int(times.size());
+		powers.resize(n);
+		status.clear();
+		bool sorted = std::is_sorted(times.begin(), times.end());	//monotone grids take the segment-walk kernels
 		if (to == 0) {									//checks is an operation duration was specified; if not, assumes infinite operation and uses ans_inf; if specfied, uses ans_fin
-			for (int i = 0; i < times.size(); i++) {
-				powers.push_back(ans_inf(times[i])*qo);
-			};
+			if (sorted) {
+				ans_inf_sorted<P>(times.data(), powers.data(), n, &status);
+			}
+			else {
+				ans_inf_batch<P>(times.data(), powers.data(), n, &status);
+			}
 		}
 		else {
-			for (int i = 0; i < times.size(); i++) {
-				powers.push_back(ans_fin(times[i], to)*qo);
-			};
+			if (sorted) {
+				ans_fin_sorted<P>(times.data(), to, powers.data(), n, &status);
+			}
+			else {
+				ans_fin_batch<P>(times.data(), to, powers.data(), n, &status);
+			}
 		}
+		for (int i = 0; i < n; i++) {
+			powers[i] *= qo;
+		};
+		dh_report(status, "fe_heat");
 	};
 
-	//	gen_corr:	generates <powers> at each timestamp using the corrected ans approximation from decay_heat.h
+	//	gen_corr:	generates <powers> at each timestamp using the corrected ans approximation from decay_heat.h; overwrites any previous result in place
 	void gen_corr() {
-		if (to == 0) {									//checks is an operation duration was specified; if not, assumes infinite operation and uses ans_inf; if specfied, uses ans_fin
-			for (int i = 0; i < times.size(); i++) {
-				std::cout << "error fe_heat	:	gen_core argument invalid, to = 0" << std::endl;
-			};
+		status.clear();
+		if (to == 0) {									//corrected approximation needs a finite operating period; flags and reports once for the whole profile
+			status.flags |= DH_TO_ZERO;
+			dh_report(status, "fe_heat");
 		}
 		else {
-			for (int i = 0; i < times.size(); i++) {
-				powers.push_back(corr_fin(times[i], to) * qo);
+			int n = int(times.size());
+			powers.resize(n);
+			if (std::is_sorted(times.begin(), times.end())) {	//monotone grids take the segment-walk kernel
+				corr_fin_sorted<P>(times.data(), to, powers.data(), n, &status);
+			}
+			else {
+				corr_fin_batch<P>(times.data(), to, powers.data(), n, &status);
+			}
+			for (int i = 0; i < n; i++) {
+				powers[i] *= qo;
 			};
+			dh_report(status, "fe_heat");
+		}
+	};
+
+	//	gen_groups:	generates <powers> at each timestamp using a multi-group exponential backend from decay_heat.h
+	void gen_groups(const dh_groups& g) {
+		powers.clear();
+		for (int i = 0; i < times.size(); i++) {
+			powers.push_back((to == 0 ? g.frac_inf(times[i]) : g.frac_fin(times[i], to)) * qo);
+		};
+	};
+
+	//	gen_hist:	generates <powers> at each timestamp using the corrected approximation superposed over a power history; replaces <to> and <qo>
+	void gen_hist(const pwr_history& h) {
+		powers.clear();
+		for (int i = 0; i < times.size(); i++) {
+			powers.push_back(h.template corr<P>(times[i]));
+		};
+	};
+
+	//	gen_adaptive:	replaces <times> and <powers> with a grid over [t_lo, t_hi] that reproduces the corrected (or, with corr false,
+	//					uncorrected) curve to relative tolerance tol under linear interpolation. Bin, ts + to and correction region
+	//					edges are always grid points, with the left limit added where the curve jumps; each smooth piece between them
+	//					is bisected in ln(ts) until the midpoint lies within tol of the chord. Returns the number of evaluations.
+	int gen_adaptive(double t_lo, double t_hi, double tol, bool corr = true) {
+		times.clear();
+		powers.clear();
+		status.clear();
+		if (corr && to == 0) {
+			status.flags |= DH_TO_ZERO;
+			dh_report(status, "fe_heat");
+			return 0;
 		}
+		t_lo = fmax(t_lo, P::bnd[0]);
+		t_hi = fmin(t_hi, std::nextafter(P::bnd[P::n_bnd - 1], 0.0));
+		int n_eval = 0;
+		auto f = [&](double t) {
+			n_eval++;
+			double q = (to == 0) ? ans_inf_bf<P>(t) : ans_inf_bf<P>(t) - ans_inf_bf<P>(t + to);
+			return (corr ? q * P::cf(t) : q) * qo;
+		};
+
+		vector <double> edge = { t_lo, t_hi };
+		for (int k = 1; k < P::n_bnd - 1; k++) {
+			edge.push_back(P::bnd[k]);
+			edge.push_back(P::bnd[k] - to);
+		};
+		for (int k = 0; corr && k < P::n_cbnd; k++) {
+			edge.push_back(P::cbnd[k]);
+		};
+		std::sort(edge.begin(), edge.end());
+		edge.erase(std::remove_if(edge.begin(), edge.end(), [t_lo, t_hi](double e) { return e < t_lo || e > t_hi; }), edge.end());
+		edge.erase(std::unique(edge.begin(), edge.end()), edge.end());
+
+		//	frame:	interval [a, b] awaiting a chord check at its geometric midpoint; every piece is split at least twice so a midpoint
+		//			that happens to sit on the chord cannot end the search early
+		struct frame {
+			double a, fa, b, fb;
+			int depth;
+		};
+		double fa = f(t_lo);
+		times.push_back(t_lo);
+		powers.push_back(fa);
+		for (int j = 0; j + 1 < int(edge.size()); j++) {
+			double a = edge[j];
+			double b = edge[j + 1];
+			bool last = (j + 2 == int(edge.size()));
+			double bl = last ? b : std::nextafter(b, 0.0);
+			double fb = f(bl);
+			vector <frame> stack = { { a, fa, bl, fb, 0 } };
+			while (!stack.empty()) {
+				frame fr = stack.back();
+				stack.pop_back();
+				double m = sqrt(fr.a * fr.b);
+				if (fr.depth > 60 || !(fr.a < m && m < fr.b)) {
+					continue;
+				}
+				double fm = f(m);
+				double chord = fr.fa + (fr.fb - fr.fa) * (m - fr.a) / (fr.b - fr.a);
+				if (fr.depth >= 2 && fabs(fm - chord) <= tol * fabs(fm)) {
+					continue;
+				}
+				times.push_back(m);				//emitted out of order, sorted below
+				powers.push_back(fm);
+				stack.push_back({ fr.a, fr.fa, m, fm, fr.depth + 1 });
+				stack.push_back({ m, fm, fr.b, fr.fb, fr.depth + 1 });
+			};
+			times.push_back(bl);
+			powers.push_back(fb);
+			if (!last) {
+				fa = f(b);
+				if (fabs(fa - fb) > tol * fabs(fa)) {		//jump at the edge; keep both sides
+					times.push_back(b);
+					powers.push_back(fa);
+				}
+				else {
+					times.back() = b;
+					powers.back() = fa;
+				}
+			}
+		};
+
+		vector <int> order(times.size());
+		for (int i = 0; i < int(order.size()); i++) {
+			order[i] = i;
+		};
+		std::sort(order.begin(), order.end(), [this](int x, int y) { return times[x] < times[y]; });
+		vector <double> t_sorted(order.size());
+		vector <double> q_sorted(order.size());
+		for (int i = 0; i < int(order.size()); i++) {
+			t_sorted[i] = times[order[i]];
+			q_sorted[i] = powers[order[i]];
+		};
+		times.swap(t_sorted);
+		powers.swap(q_sorted);
+		return n_eval;
 	};
 
 	//	exp_prof:		exports times and powers to a local .csv
@@ -82,8 +310,160 @@ struct dh_profile {
 
 };
 
-//	lot:	stores data for a regular series of spent fuel elements
-struct lot {
+typedef dh_profile_t<ans_tk> dh_profile;
+
+//	adaptive_profile:	builds a dh_profile over [t_lo, t_hi] for operating period to and power qo through gen_adaptive
+template <class P = ans_tk>
+dh_profile_t<P> adaptive_profile(double t_lo, double t_hi, double to, double qo, double tol, bool corr = true) {
+	dh_profile_t<P> prof;
+	prof.to = to;
+	prof.qo = qo;
+	prof.gen_adaptive(t_lo, t_hi, tol, corr);
+	return prof;
+}
+
+//	dh_profile_set:	many profiles in one block. Time axes are stored end to end in <times>, and profile p's powers fill a row of
+//					<powers> as long as its axis, rows end to end, so profiles on a shared axis form a contiguous matrix. add() sizes the
+//					row once; gen_ans/gen_corr then overwrite rows in place, so edited <to> or <qo> values regenerate without reallocation.
+template <class P>
+struct dh_profile_set_t {
+	vector <double> times;			//time axes, end to end (s)
+	vector <long long> axis_off;	//start of axis a in <times>; axis_off[a + 1] - axis_off[a] is its length
+	vector <char> axis_sorted;		//whether axis a is non-decreasing, so it can take the segment-walk kernels
+	vector <int> axis;				//axis used by each profile
+	vector <double> to;				//operating period of each profile (s)
+	vector <double> qo;				//operating power of each profile
+	vector <double> powers;			//profile rows, end to end
+	vector <long long> row_off;		//start of each profile's row in <powers>
+	dh_status status;				//out-of-range tally from the last gen_ans/gen_corr over all profiles
+
+	dh_profile_set_t() {
+		axis_off = { 0 };
+		row_off = { 0 };
+	}
+
+	//	add_axis():	appends a time axis and returns its index
+	int add_axis(const vector <double>& t) {
+		times.insert(times.end(), t.begin(), t.end());
+		axis_off.push_back(times.size());
+		axis_sorted.push_back(std::is_sorted(t.begin(), t.end()));
+		return int(axis_sorted.size()) - 1;
+	}
+
+	//	add():		appends a profile on axis a and returns its index; its row is sized here and zeroed until generated
+	int add(int a, double toi, double qoi = 1) {
+		axis.push_back(a);
+		to.push_back(toi);
+		qo.push_back(qoi);
+		powers.resize(powers.size() + (axis_off[a + 1] - axis_off[a]), 0);
+		row_off.push_back(powers.size());
+		return int(axis.size()) - 1;
+	}
+
+	int size() const {
+		return int(axis.size());
+	}
+
+	//	length():	number of timestamps in profile p
+	int length(int p) const {
+		return int(row_off[p + 1] - row_off[p]);
+	}
+
+	const double* t(int p) const {
+		return &times[axis_off[axis[p]]];
+	}
+
+	double* row(int p) {
+		return &powers[row_off[p]];
+	}
+
+	//	gen_ans:	fills every row with the uncorrected approximation, ans_inf where to = 0
+	void gen_ans() {
+		status.clear();
+		for (int p = 0; p < size(); p++) {
+			int n = length(p);
+			if (to[p] == 0) {
+				if (axis_sorted[axis[p]]) {
+					ans_inf_sorted<P>(t(p), row(p), n, &status);
+				}
+				else {
+					ans_inf_batch<P>(t(p), row(p), n, &status);
+				}
+			}
+			else if (axis_sorted[axis[p]]) {
+				ans_fin_sorted<P>(t(p), to[p], row(p), n, &status);
+			}
+			else {
+				ans_fin_batch<P>(t(p), to[p], row(p), n, &status);
+			}
+			scale(p);
+		};
+		dh_report(status, "fe_heat");
+	}
+
+	//	gen_corr:	fills every row with the corrected approximation; rows with to = 0 are zeroed and flagged
+	void gen_corr() {
+		status.clear();
+		for (int p = 0; p < size(); p++) {
+			int n = length(p);
+			if (to[p] == 0) {
+				status.flags |= DH_TO_ZERO;
+				std::fill(row(p), row(p) + n, 0.0);
+			}
+			else if (axis_sorted[axis[p]]) {
+				corr_fin_sorted<P>(t(p), to[p], row(p), n, &status);
+			}
+			else {
+				corr_fin_batch<P>(t(p), to[p], row(p), n, &status);
+			}
+			scale(p);
+		};
+		dh_report(status, "fe_heat");
+	}
+
+	void scale(int p) {
+		double* q = row(p);
+		for (int i = 0; i < length(p); i++) {
+			q[i] *= qo[p];
+		};
+	}
+
+	//	profile():	copies profile p out as a dh_profile
+	dh_profile_t<P> profile(int p) const {
+		dh_profile_t<P> prof(vector <double>(t(p), t(p) + length(p)));
+		prof.to = to[p];
+		prof.qo = qo[p];
+		prof.powers.assign(powers.begin() + row_off[p], powers.begin() + row_off[p + 1]);
+		return prof;
+	}
+
+	//	exp_axis():	exports axis a to a local .csv, one row per timestamp with the time followed by each profile on the axis
+	void exp_axis(int a, string& filename) {
+		vector <int> on;
+		for (int p = 0; p < size(); p++) {
+			if (axis[p] == a) {
+				on.push_back(p);
+			}
+		};
+		int csv_width = int(on.size()) + 1;
+		int csv_length = int(axis_off[a + 1] - axis_off[a]);
+		vector <double> csv_output;
+		csv_output.reserve(csv_width * csv_length);
+		for (int i = 0; i < csv_length; i++) {
+			csv_output.push_back(times[axis_off[a] + i]);
+			for (int j = 0; j < int(on.size()); j++) {
+				csv_output.push_back(powers[row_off[on[j]] + i]);
+			};
+		};
+		write2csv(csv_output, filename, csv_width, csv_length);
+	}
+};
+
+typedef dh_profile_set_t<ans_tk> dh_profile_set;
+
+//	lot:	stores data for a regular series of spent fuel elements; templated on a correlation policy from decay_heat.h
+template <class P>
+struct lot_t {
 	double	to;		//length of operation prior to discharge
 	double	qo;		//avg element power prior to discharge
 	double	tr;		//residence time, ie. maximum age of oldest lot member
@@ -91,35 +471,298 @@ struct lot {
 	double	rate;	//rate at which new elements are added to lot, ie. inverse of timestep between elements
 	int		size;	//alternative to rate, size of lot which is then used to calculate timestamps for lot members based on residence
 	vector <double> powers;
+	vector <float> powers_f;	//member powers from gen_corr_f
 	double	q_net;	//lumped decay heat generated by lot
+	dh_status status;	//out-of-range tally from the last gen_corr
 
-	lot() = default;
-	lot(double& toi, double& qoi, double& tri, double& tro, double& ri) {
+	lot_t() = default;
+	lot_t(double& toi, double& qoi, double& tri, double& troi, double& ri) {
 		to = toi;
 		qo = qoi;
 		tr = tri;
+		tro = troi;
 		rate = ri;
 		size = floor(tri * ri);
 		q_net = 0;
 	}
-	lot(double& toi, double& qoi, double& tri, double& tro, int& si) {
+	lot_t(double& toi, double& qoi, double& tri, double& troi, int& si) {
 		to = toi;
 		qo = qoi;
 		tr = tri;
+		tro = troi;
 		rate = si / tri;
 		size = si;
 		q_net = 0;
 	}
+	template <class Q>
+	explicit lot_t(const lot_t<Q>& o) {			//copies the lot parameters of a lot under another policy; <powers> is left empty
+		to = o.to;
+		qo = o.qo;
+		tr = o.tr;
+		tro = o.tro;
+		rate = o.rate;
+		size = o.size;
+		q_net = 0;
+	}
 
 	void gen_corr() {							//fills <powers> with the decay heat produced by each member of the lot; also tallies total heat generated by lot
 		double ts = tro;							//initializes and/or resets ts
 		q_net = 0;								//resets q_net to prevent accumulation if function is called multiple times
-		powers.clear();							//resets powers to prevent appending duplicate data if the function is called twice
+		powers.resize(size + 1);				//sized once; reuses storage if the function is called twice
+		for (int i = 0; i < size + 1; i++) {		//stages member timestamps in <powers>, which corr_fin_sorted then overwrites in place
+			ts += (1 / rate);
+			powers[i] = ts;
+		};
+		status.clear();
+		corr_fin_sorted<P>(powers.data(), to, powers.data(), size + 1, &status);	//member timestamps are increasing
+		for (int i = 0; i < size + 1; i++) {
+			powers[i] *= qo;
+			q_net += powers[i];
+		};
+		dh_report(status, "fe_heat");
+	}
+
+	void gen_corr_f() {							//as gen_corr(), evaluating members in float32 into <powers_f> at half the memory; q_net is still accumulated in double
+		q_net = 0;
+		powers_f.resize(size + 1);
+		for (int i = 0; i < size + 1; i++) {
+			powers_f[i] = float(tro + (i + 1) / rate);
+		};
+		status.clear();
+		corr_fin_sorted_f<P>(powers_f.data(), float(to), powers_f.data(), size + 1, &status);	//member timestamps are increasing
+		float qf = float(qo);
+		for (int i = 0; i < size + 1; i++) {
+			powers_f[i] *= qf;
+			q_net += powers_f[i];
+		};
+		dh_report(status, "fe_heat");
+	}
+
+	template <class... R>
+	void gen_stream(R&... red) {				//as gen_corr(), passing member powers block by block to reducers <red> instead of filling <powers>; q_net matches gen_corr()
+		gen_stream_at(0, red...);
+	}
+
+	template <class... R>
+	void gen_stream_at(long long i_base, R&... red) {		//as gen_stream(), with members numbered from <i_base> in add(), so reducers fed several lots see distinct indices
+		double buf[stream_block];
+		double ts = tro;
+		q_net = 0;
+		status.clear();
+		for (int i0 = 0; i0 < size + 1; i0 += stream_block) {
+			int n = std::min(stream_block, size + 1 - i0);
+			for (int i = 0; i < n; i++) {
+				ts += (1 / rate);
+				buf[i] = ts;
+			};
+			corr_fin_sorted<P>(buf, to, buf, n, &status);
+			for (int i = 0; i < n; i++) {
+				buf[i] *= qo;
+				q_net += buf[i];
+			};
+			int pass[] = { 0, (red.add(buf, n, i_base + i0), 0)... };
+			(void)pass;
+		};
+		dh_report(status, "fe_heat");
+	}
+
+	void gen_corr_par(int nt = 0, bool report = true) {		//as gen_corr(), on nt workers (0 for all cores) with q_net from a chunked compensated sum that is identical on any nt;
+		powers.resize(size + 1);				//member times are computed directly as tro + i / rate rather than accumulated, so they differ from gen_corr() in the last digits.
+												//With report false, <status> is left for the caller to report, as when lots are themselves run on several threads
+		long long n = size + 1;
+		long long nc = (n + red_chunk - 1) / red_chunk;
+		vector <double> part(nc);
+		vector <dh_status> st(n_threads(nt));
+		par_for(nc, nt, [&](int w, long long c0, long long c1) {
+			for (long long c = c0; c < c1; c++) {
+				long long i0 = c * red_chunk;
+				int m = int((n - i0 < red_chunk) ? n - i0 : red_chunk);
+				double* q = &powers[i0];
+				for (int i = 0; i < m; i++) {
+					q[i] = tro + (i0 + i + 1) / rate;
+				};
+				corr_fin_sorted<P>(q, to, q, m, &st[w]);
+				for (int i = 0; i < m; i++) {
+					q[i] *= qo;
+				};
+				part[c] = chunk_sum(q, m);
+			};
+		});
+		q_net = pair_sum(part.data(), nc);
+		status.clear();
+		for (int w = 0; w < int(st.size()); w++) {
+			status.tally(st[w].n_low, st[w].n_high, st[w].n_tse_high);
+		};
+		if (report) {
+			dh_report(status, "fe_heat");
+		}
+	}
+
+	void gen_corr(const corr_cheb_t<P>& tab) {		//as gen_corr(), evaluating members through a corr_cheb surrogate built for this lot's <to>
+		double ts = tro;
+		q_net = 0;
+		powers.resize(size + 1);
+		for (int i = 0; i < size + 1; i++) {
+			ts += (1 / rate);
+			powers[i] = ts;
+		};
+		tab.eval_batch(powers.data(), powers.data(), size + 1);
+		for (int i = 0; i < size + 1; i++) {
+			powers[i] *= qo;
+			q_net += powers[i];
+		};
+	}
+
+	void gen_groups(const dh_groups& g) {		//tallies q_net through a multi-group backend in O(groups), independent of lot size; <powers> is not filled
+		q_net = qo * g.lot_sum(tro + 1 / rate, 1 / rate, size + 1, to);
+	}
+
+	void gen_hist(const pwr_history& h) {		//as gen_corr(), with every member following element power history h in place of <to> and <qo>
+		double ts = tro;
+		q_net = 0;
+		powers.resize(size + 1);
 		for (int i = 0; i < size + 1; i++) {
 			ts += (1 / rate);
-			powers.push_back(qo * corr_fin(ts, to));
-			q_net += (qo * corr_fin(ts, to));
+			powers[i] = h.template corr<P>(ts);
+			q_net += powers[i];
+		};
+	}
+
+	double gen_corr_em() {						//tallies q_net by Euler-Maclaurin summation in O(corr_fin segments), independent of lot size; returns the error estimate (kW). <powers> is not filled
+		double err = 0;
+		q_net = qo * corr_fin_sum<P>(tro + 1 / rate, 1 / rate, size + 1, to, err);
+		return qo * err;
+	}
+
+	dual<4> gen_corr_ad() {						//as gen_corr(), returning q_net with its gradient with respect to {to, qo, tr, rate} in one pass; <powers> is not filled
+		typedef dual<4> d4;
+		d4 t_o = d4::var(to, 0);
+		d4 q_o = d4::var(qo, 1);
+		d4 t_r = d4::var(tr, 2);
+		d4 r = d4::var(rate, 3);
+		d4 h = d4(1) / r;
+		d4 q(0);
+		d4 ts;
+		for (int i = 0; i < size + 1; i++) {
+			ts = tro + (i + 1) * h;
+			q += corr_fin_bf<P>(ts, t_o);
+		};
+		d4 n = t_r * r;									//size = floor(tr * rate) is relaxed to a fractional last member, so d/dtr is continuous
+		q += (n - n.v) * corr_fin_bf<P>(ts, t_o);		//carries only the derivative of the fractional member
+		double t_end = ts.v;
+		for (int j = 1; j < P::n_bnd + P::n_cbnd - 1; j++) {		//members crossing a jump of the fit; the pointwise derivative misses these, a difference quotient does not
+			double b = (j < P::n_bnd - 1) ? P::bnd[j] : P::cbnd[j - P::n_bnd + 1];
+			if (tro < b && b <= t_end) {
+				q.d[3] += (b - tro) * (corr_fin_bf<P>(std::nextafter(b, 0.0), to) - corr_fin_bf<P>(b, to));
+			}
+			double c = b - to;									//members whose ts + to crosses b; the jump enters q through -ans_inf(ts + to)
+			if (j < P::n_bnd - 1 && tro < c && c <= t_end) {
+				double dA = (ans_inf_bf<P>(b) - ans_inf_bf<P>(std::nextafter(b, 0.0))) * P::cf(c);
+				q.d[0] -= rate * dA;
+				q.d[3] += (c - tro) * dA;
+			}
+		};
+		q *= q_o;
+		q_net = q.v;
+		return q;
+	}
+
+	double gen_binned(double tol, long long* n_eval = nullptr) {		//tallies q_net from member age bins, one corr_fin call per bin weighted by its member count; returns the error estimate (kW). <powers> is not filled
+		long long n = size + 1;													//bins never straddle a bin, ts + to or correction region edge; within a piece a bin is
+		double h = 1 / rate;													//halved until its one-point and two-point sums agree to tol, so q_net is met to about tol
+		auto ts_at = [this, h](double i) { return tro + (i + 1) * h; };		//relative. Member times are tro + (i + 1) / rate
+		long long evals = 0;
+		auto f = [&](double i) {
+			evals++;
+			return corr_fin_bf<P>(ts_at(i), to);
+		};
+
+		vector <long long> cuts = { 0, n };
+		vector <double> edge;
+		for (int k = 0; k < P::n_bnd; k++) {
+			edge.push_back(P::bnd[k]);
+			edge.push_back(P::bnd[k] - to);
+		};
+		for (int k = 0; k < P::n_cbnd; k++) {
+			edge.push_back(P::cbnd[k]);
+		};
+		for (int k = 0; k < int(edge.size()); k++) {
+			double i = ceil((edge[k] - tro) * rate - 1);		//first member with ts >= edge
+			if (0 < i && i < n) {
+				cuts.push_back((long long)i);
+			}
+		};
+		std::sort(cuts.begin(), cuts.end());
+		cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+
+		struct frame {
+			long long a, b;			//member index range [a, b)
+			double s1;				//one-point sum over the range
+		};
+		double q = 0;
+		double err = 0;
+		for (int c = 0; c + 1 < int(cuts.size()); c++) {
+			long long a = cuts[c];
+			long long b = cuts[c + 1];
+			vector <frame> stack = { { a, b, (b - a) * f(0.5 * (a + b - 1)) } };
+			while (!stack.empty()) {
+				frame fr = stack.back();
+				stack.pop_back();
+				long long m = fr.b - fr.a;
+				if (m <= 2) {
+					double s = 0;
+					for (long long i = fr.a; i < fr.b; i++) {
+						s += f(double(i));
+					};
+					q += s;
+					continue;
+				}
+				long long mid = fr.a + m / 2;
+				double sl = (mid - fr.a) * f(0.5 * (fr.a + mid - 1));
+				double sr = (fr.b - mid) * f(0.5 * (mid + fr.b - 1));
+				double d = fabs(sl + sr - fr.s1);
+				if (d <= tol * fabs(sl + sr)) {
+					q += sl + sr;
+					err += d / 3;				//two-point error is about a quarter of the one-point error d
+					continue;
+				}
+				stack.push_back({ fr.a, mid, sl });
+				stack.push_back({ mid, fr.b, sr });
+			};
+		};
+		q_net = qo * q;
+		if (n_eval != nullptr) {
+			*n_eval = evals;
+		}
+		return qo * err;
+	}
+
+	double energy(double t1, double t2) {		//decay energy released by the current members between t1 and t2 seconds after the lot's reference time (kJ for qo in kW); summed over members by energy_sum in O(segments)
+		double err = 0;
+		return qo * energy_sum<P>(tro + 1 / rate, 1 / rate, size + 1, t1, t2, to, err);
+	}
+
+	double time_below(double q_target) {		//time after the lot's reference (no further arrivals) at which q_net falls below q_target (kW); each trial is an O(segments) corr_fin_sum
+		double err = 0;
+		double h = 1 / rate;
+		auto g = [&](double x) { return qo * corr_fin_sum<P>(tro + h + exp(x), h, size + 1, to, err) - q_target; };
+		double xa = log(1.0);
+		double ga = g(xa);
+		if (ga < 0) {
+			return 0;
+		}
+		double xb = xa;
+		double gb = ga;
+		while (gb >= 0 && xb < log(P::bnd[P::n_bnd - 1])) {		//brackets the crossing by decades
+			xa = xb;
+			ga = gb;
+			xb += log(10.0);
+			gb = g(xb);
 		};
+		if (gb >= 0) {
+			return HUGE_VAL;
+		}
+		return exp(dh_root(g, xa, xb, ga, gb, 0.5 * (xa + xb)));
 	}
 
 	void tot_heat() {
@@ -128,10 +771,94 @@ struct lot {
 
 };
 
+typedef lot_t<ans_tk> lot;
+
+//	lot_het:	lot whose elements each carry their own discharge time, operating period and power, stored as separate contiguous arrays
+//				(32 bytes per element with <powers>). Members need not be evenly spaced or ordered; heat is evaluated at time <t_eval>
+//				through the per-element corr_fin_batch_to kernel. Has the gen_corr()/q_net interface lotArray_t uses, so lotArray_t<P,
+//				lot_het_t<P>> holds columns of them.
+template <class P>
+struct lot_het_t {
+	vector <double> td;		//discharge time of each element (s)
+	vector <double> to;		//operating period of each element prior to discharge (s)
+	vector <double> qo;		//avg power of each element prior to discharge
+	vector <double> powers;	//element powers at <t_eval>
+	double	t_eval;			//time heat is evaluated at, on the same clock as <td>
+	double	q_net;			//lumped decay heat generated by lot
+	dh_status status;		//out-of-range tally from the last gen_corr
+
+	lot_het_t() {
+		t_eval = 0;
+		q_net = 0;
+	}
+
+	void reserve(int n) {
+		td.reserve(n);
+		to.reserve(n);
+		qo.reserve(n);
+	}
+
+	//	add():		appends an element discharged at tdi after operating for toi at power qoi
+	void add(double tdi, double toi, double qoi) {
+		td.push_back(tdi);
+		to.push_back(toi);
+		qo.push_back(qoi);
+	}
+
+	int size() const {
+		return int(td.size());
+	}
+
+	void gen_corr() {						//fills <powers> with each element's decay heat at <t_eval> and tallies q_net
+		int n = size();
+		powers.resize(n);
+		q_net = 0;
+		status.clear();
+		for (int i0 = 0; i0 < n; i0 += stream_block) {		//block by block so the staged cooling times are still in L1 for the scaling pass
+			int m = std::min(stream_block, n - i0);
+			double* pw = &powers[i0];
+			for (int i = 0; i < m; i++) {		//stages cooling times in <powers>, which corr_fin_batch_to then overwrites in place
+				pw[i] = t_eval - td[i0 + i];
+			};
+			corr_fin_batch_to<P>(pw, &to[i0], pw, m, &status);
+			for (int i = 0; i < m; i++) {
+				pw[i] *= qo[i0 + i];
+				q_net += pw[i];
+			};
+		};
+		dh_report(status, "fe_heat");
+	}
+
+	void gen_sum() {						//as gen_corr(), block by block without filling <powers>
+		double buf[stream_block];
+		int n = size();
+		q_net = 0;
+		status.clear();
+		for (int i0 = 0; i0 < n; i0 += stream_block) {
+			int m = std::min(stream_block, n - i0);
+			for (int i = 0; i < m; i++) {
+				buf[i] = t_eval - td[i0 + i];
+			};
+			corr_fin_batch_to<P>(buf, &to[i0], buf, m, &status);
+			for (int i = 0; i < m; i++) {
+				q_net += buf[i] * qo[i0 + i];
+			};
+		};
+		dh_report(status, "fe_heat");
+	}
+
+	void tot_heat() {
+		std::cout << "lumped heat generation:	" << q_net << " kW" << std::endl;
+	}
+};
+
+typedef lot_het_t<ans_tk> lot_het;
+
 //	--== functions ==--
 
 //	res_study:	computes lumped heat generation rate for different residence times using a lot input and residence vector
-vector <double> res_study(lot refLot, vector <double> &resVec) {
+template <class P>
+vector <double> res_study(lot_t<P> refLot, vector <double> &resVec) {
 	vector <double> studyHeats;
 	for (int i = 0; i < resVec.size(); i++) {
 		refLot.tr = resVec[i];							//updates residence time of lot to resVec input value
@@ -142,6 +869,133 @@ vector <double> res_study(lot refLot, vector <double> &resVec) {
 	return studyHeats;
 }
 
+//	res_study:	as above, evaluating every lot through a corr_cheb surrogate built once for refLot.to
+template <class P>
+vector <double> res_study(lot_t<P> refLot, vector <double>& resVec, double tol) {
+	corr_cheb_t<P> tab(refLot.to, tol);
+	vector <double> studyHeats;
+	for (int i = 0; i < resVec.size(); i++) {
+		refLot.tr = resVec[i];
+		refLot.size = floor(refLot.tr * refLot.rate);
+		refLot.gen_corr(tab);
+		studyHeats.push_back(refLot.q_net);
+	};
+	return studyHeats;
+}
+
+//	res_sweep:	as res_study, evaluating the member grid once up to the longest residence; a longer residence only appends older members
+//				to the same grid, so each q_net is read off a running sum of member powers. Sums run in the same order as gen_corr, so
+//				results match res_study
+template <class P>
+vector <double> res_sweep(lot_t<P> refLot, vector <double>& resVec) {
+	vector <double> studyHeats;
+	if (resVec.empty()) {
+		return studyHeats;
+	}
+	double tr_max = *std::max_element(resVec.begin(), resVec.end());
+	int n = int(floor(tr_max * refLot.rate)) + 1;
+	vector <double> q(n);
+	double ts = refLot.tro;
+	for (int i = 0; i < n; i++) {
+		ts += (1 / refLot.rate);
+		q[i] = ts;
+	};
+	refLot.status.clear();
+	corr_fin_sorted<P>(q.data(), refLot.to, q.data(), n, &refLot.status);
+	dh_report(refLot.status, "fe_heat");
+	double run = 0;
+	for (int i = 0; i < n; i++) {			//q[i] becomes the lumped heat of the first i + 1 members
+		run += q[i] * refLot.qo;
+		q[i] = run;
+	};
+	for (int i = 0; i < int(resVec.size()); i++) {
+		int size = int(floor(resVec[i] * refLot.rate));
+		studyHeats.push_back(q[size]);
+	};
+	return studyHeats;
+}
+
+//	sweep_grid:	lumped heat over the Cartesian product of rate, qo, to and tr, preallocated as one array with tr varying fastest
+struct sweep_grid {
+	vector <double> rates;
+	vector <double> qos;
+	vector <double> tos;
+	vector <double> trs;
+	vector <double> q_net;		//q_net[at(i, j, k, l)] for rates[i], qos[j], tos[k], trs[l] (kW)
+
+	sweep_grid() = default;
+	sweep_grid(const vector <double>& ri, const vector <double>& qi, const vector <double>& ti, const vector <double>& tri) {
+		rates = ri;
+		qos = qi;
+		tos = ti;
+		trs = tri;
+		q_net.assign(rates.size() * qos.size() * tos.size() * trs.size(), 0);
+	}
+
+	size_t at(size_t i, size_t j, size_t k, size_t l) const {
+		return ((i * qos.size() + j) * tos.size() + k) * trs.size() + l;
+	}
+};
+
+//	res_sweep_par:	fills g.q_net for lots shaped like refLot (tro), with the (rate, to) combinations spread over nt workers (0 for all
+//					cores). Each combination builds its member grid once up to the longest tr and reads every tr off the running sum as
+//					res_sweep does; qo enters as a scale factor, so it costs nothing extra. Combinations are independent and write
+//					disjoint parts of g.q_net, so the sweep scales with cores.
+template <class P>
+void res_sweep_par(const lot_t<P>& refLot, sweep_grid& g, int nt = 0) {
+	if (g.trs.empty()) {
+		return;
+	}
+	double tr_max = *std::max_element(g.trs.begin(), g.trs.end());
+	long long n_comb = (long long)(g.rates.size() * g.tos.size());
+	vector <dh_status> st(n_threads(nt));
+	par_for(n_comb, nt, [&](int w, long long c0, long long c1) {
+		vector <double> q;
+		for (long long c = c0; c < c1; c++) {
+			size_t i = size_t(c / g.tos.size());
+			size_t k = size_t(c % g.tos.size());
+			double rate = g.rates[i];
+			double to = g.tos[k];
+			int n = int(floor(tr_max * rate)) + 1;
+			q.resize(n);
+			double ts = refLot.tro;
+			for (int m = 0; m < n; m++) {
+				ts += (1 / rate);
+				q[m] = ts;
+			};
+			corr_fin_sorted<P>(q.data(), to, q.data(), n, &st[w]);
+			double run = 0;
+			for (int m = 0; m < n; m++) {
+				run += q[m];
+				q[m] = run;
+			};
+			for (size_t l = 0; l < g.trs.size(); l++) {
+				double frac = q[int(floor(g.trs[l] * rate))];
+				for (size_t j = 0; j < g.qos.size(); j++) {
+					g.q_net[g.at(i, j, k, l)] = g.qos[j] * frac;
+				};
+			};
+		};
+	});
+	dh_status total;
+	for (int w = 0; w < int(st.size()); w++) {
+		total.tally(st[w].n_low, st[w].n_high, st[w].n_tse_high);
+	};
+	dh_report(total, "fe_heat");
+}
+
+//	res_study_ad:	as res_study, returning each lumped heat with its gradient with respect to {to, qo, tr, rate} from gen_corr_ad
+template <class P>
+vector <dual<4>> res_study_ad(lot_t<P> refLot, vector <double>& resVec) {
+	vector <dual<4>> studyHeats;
+	for (int i = 0; i < resVec.size(); i++) {
+		refLot.tr = resVec[i];
+		refLot.size = floor(refLot.tr * refLot.rate);
+		studyHeats.push_back(refLot.gen_corr_ad());
+	};
+	return studyHeats;
+}
+
 //	--== test cases ==--
 
 #endif
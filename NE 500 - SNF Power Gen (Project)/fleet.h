@@ -0,0 +1,165 @@
+//	fleet.h
+//	Author:	A. Wells
+//	Date:	2026-10-17
+
+//	Description:
+//	Fleet-level decay heat: reactors discharging into lotArrays, grouped into storage facilities, with cached subtotals at every level
+
+#ifndef _FLEET_
+#define _FLEET_
+
+#include <vector>
+
+#include "heat_source.h"
+
+//	--== structs ==--
+
+//	facility:	storage facility holding one lotArray per reactor discharging into it. Array heats and the facility total are cached;
+//				edit() or set_reactor() marks one array stale, and total() recomputes only stale arrays. Arrays are summed by
+//				Euler-Maclaurin (arrayHeats_em) unless <em> is false, so a recompute costs O(lots) whatever the element count.
+template <class P>
+struct facility_t {
+	string name;
+	vector <lotArray_t<P>> arrays;		//one per reactor
+	vector <double> heats;				//cached array heats
+	vector <char> stale;				//arrays whose cached heat is out of date
+	double q_net;						//cached facility heat
+	bool	dirty;						//whether any array is stale
+	bool	em;							//Euler-Maclaurin array sums; false runs gen_corr on every lot
+	long long n_eval;					//arrays recomputed so far
+
+	facility_t() {
+		q_net = 0;
+		dirty = false;
+		em = true;
+		n_eval = 0;
+	}
+	facility_t(string n) : facility_t() {
+		name = n;
+	}
+
+	//	add():		appends an array, generating its lots if it has none, and returns its index
+	int add(const lotArray_t<P>& a) {
+		arrays.push_back(a);
+		if (arrays.back().lots.empty()) {
+			double tro = 0;
+			arrays.back().arrayGen(tro);
+		}
+		heats.push_back(0);
+		stale.push_back(1);
+		dirty = true;
+		return int(arrays.size()) - 1;
+	}
+
+	//	edit():		gives write access to array a and marks it stale; call again after each change made through the reference
+	lotArray_t<P>& edit(int a) {
+		stale[a] = 1;
+		dirty = true;
+		return arrays[a];
+	}
+
+	//	set_reactor():	changes the discharge parameters of array a and regenerates its lots
+	void set_reactor(int a, double rate, double tr, double to, double qo) {
+		lotArray_t<P>& arr = edit(a);
+		arr.dRate = rate;
+		arr.dInterval = 1 / rate;
+		arr.tr = tr;
+		arr.to = to;
+		arr.qo = qo;
+		double tro = 0;
+		arr.arrayGen(tro);
+	}
+
+	//	total():	facility heat, recomputing stale arrays only
+	double total() {
+		if (!dirty) {
+			return q_net;
+		}
+		q_net = 0;
+		for (int a = 0; a < int(arrays.size()); a++) {
+			if (stale[a]) {
+				if (em) {
+					arrays[a].arrayHeats_em();
+				}
+				else {
+					arrays[a].arrayHeats();
+				}
+				arrays[a].netHeat();
+				heats[a] = arrays[a].q_net;
+				stale[a] = 0;
+				n_eval++;
+			}
+			q_net += heats[a];
+		};
+		dirty = false;
+		return q_net;
+	}
+};
+
+typedef facility_t<ans_tk> facility;
+
+//	fleet:		set of facilities with a cached fleet total; edit(f, a) hands out array a of facility f and marks that array stale,
+//				so total() and breakdown() recompute only stale arrays while clean facilities return their cache
+template <class P>
+struct fleet_t {
+	vector <facility_t<P>> facs;
+	double q_net;						//cached fleet heat
+	bool	dirty;
+
+	fleet_t() {
+		q_net = 0;
+		dirty = false;
+	}
+
+	int add(const facility_t<P>& f) {
+		facs.push_back(f);
+		dirty = true;
+		return int(facs.size()) - 1;
+	}
+
+	//	edit():		gives write access to array a of facility f and marks it stale; call again after each change made through the reference
+	lotArray_t<P>& edit(int f, int a) {
+		dirty = true;
+		return facs[f].edit(a);
+	}
+
+	//	set_reactor():	changes the discharge parameters of array a in facility f; only that branch is recomputed
+	void set_reactor(int f, int a, double rate, double tr, double to, double qo) {
+		dirty = true;
+		facs[f].set_reactor(a, rate, tr, to, qo);
+	}
+
+	double total() {
+		if (!dirty) {
+			return q_net;
+		}
+		q_net = 0;
+		for (int f = 0; f < int(facs.size()); f++) {
+			q_net += facs[f].total();			//clean facilities return their cache
+		};
+		dirty = false;
+		return q_net;
+	}
+
+	//	breakdown():	heat of each facility
+	vector <double> breakdown() {
+		total();
+		vector <double> out;
+		for (int f = 0; f < int(facs.size()); f++) {
+			out.push_back(facs[f].q_net);
+		};
+		return out;
+	}
+
+	void report() {
+		total();
+		for (int f = 0; f < int(facs.size()); f++) {
+			std::cout << "facility " << facs[f].name << ":	" << facs[f].q_net << " kW" << std::endl;
+		};
+		std::cout << "fleet total:	" << q_net << " kW" << std::endl;
+	}
+};
+
+typedef fleet_t<ans_tk> fleet;
+
+#endif
@@ -17,8 +17,10 @@
 
 //	--== structs ==--
 
-//	lotArray:	allows creation and modeling of a multi-lot array, with sequential assignment of newly discharged fuel elements and support
-struct lotArray {
+//	lotArray:	allows creation and modeling of a multi-lot array, with sequential assignment of newly discharged fuel elements and support; templated on a correlation policy from decay_heat.h
+//				and a column type <L>, either an evenly spaced lot_t built by arrayGen() or a lot_het_t filled by the caller
+template <class P, class L = lot_t<P>>
+struct lotArray_t {
 	int nLots;			//number of lots to simulate
 	double dInterval;	//time between FE dispensation
 	double dRate;		//rate of discharge
@@ -26,11 +28,11 @@ struct lotArray {
 	double to;			//operational lifespan of FE
 	double qo;			//average FE power during operation
 	double q_net;		//net heat generated by lot array
-	vector <lot> lots;		//vector containing the lots comprising the array
+	vector <L> lots;		//vector containing the lots comprising the array
 	vector <double> heats;	//vector of heat contribution of the various lots
 
-	lotArray() = default;
-	lotArray(int n, double& ri, double& tri, double& toi, double& qoi) {
+	lotArray_t() = default;
+	lotArray_t(int n, double& ri, double& tri, double& toi, double& qoi) {
 		nLots = n;
 		dRate = ri;
 		dInterval = 1 / ri;
@@ -38,14 +40,28 @@ struct lotArray {
 		to = toi;
 		qo = qoi;
 	}
+	template <class Q>
+	explicit lotArray_t(const lotArray_t<Q>& o) {	//copies an array and its lots under another policy
+		nLots = o.nLots;
+		dRate = o.dRate;
+		dInterval = o.dInterval;
+		tr = o.tr;
+		to = o.to;
+		qo = o.qo;
+		q_net = 0;
+		for (int j = 0; j < int(o.lots.size()); j++) {
+			lots.push_back(L(o.lots[j]));
+		};
+	}
 
 	//	arrayGen():		generates vector of lots
 	void arrayGen(double& troi) {
 		double tro = troi;
 		double lot_rate = dRate / nLots;
 		lots.clear();
+		lots.reserve(nLots);
 		for (int i = 0; i < nLots; i++) {
-			lots.push_back(lot(to, qo, tr, tro, lot_rate));
+			lots.push_back(L(to, qo, tr, tro, lot_rate));
 			tro += dInterval;
 		};
 	}
@@ -64,6 +80,72 @@ struct lotArray {
 		};
 	}
 
+	//	arrayHeats_f():	as arrayHeats(), with each column evaluated through the float32 path
+	void arrayHeats_f() {
+		heats.clear();
+		for (int j = 0; j < nLots; j++) {
+			lots[j].gen_corr_f();
+			heats.push_back(lots[j].q_net);
+		};
+	}
+
+	//	arrayHeats_stream():	as arrayHeats(), streaming each column's member powers into reducers <red> without storing them; members are
+	//							numbered across the array, column j's following column j-1's, so indices from red_max or red_topk are unique
+	template <class... R>
+	void arrayHeats_stream(R&... red) {
+		heats.clear();
+		long long i_base = 0;
+		for (int j = 0; j < nLots; j++) {
+			lots[j].gen_stream_at(i_base, red...);
+			i_base += lots[j].size + 1;
+			heats.push_back(lots[j].q_net);
+		};
+	}
+
+	//	arrayHeats_par():	as arrayHeats(), with columns split over nt workers (0 for all cores); each column is summed by gen_corr_par
+	//						on its own worker, so <heats> is identical on any nt. Out-of-range inputs are reported once, after the workers join
+	void arrayHeats_par(int nt = 0) {
+		heats.assign(nLots, 0);
+		par_for(nLots, nt, [&](int, long long j0, long long j1) {
+			for (long long j = j0; j < j1; j++) {
+				lots[j].gen_corr_par(1, false);
+				heats[j] = lots[j].q_net;
+			};
+		});
+		dh_status st;
+		for (int j = 0; j < nLots; j++) {
+			st.tally(lots[j].status.n_low, lots[j].status.n_high, lots[j].status.n_tse_high);
+		};
+		dh_report(st, "heat_source");
+	}
+
+	//	netHeat_det():	as netHeat(), through the chunked compensated sum from parallel.h
+	void netHeat_det() {
+		q_net = det_sum(heats.data(), heats.size(), 1);
+	}
+
+	//	arrayHeats_binned():	as arrayHeats(), with each column tallied from age bins to relative tolerance tol; returns the summed error estimate
+	double arrayHeats_binned(double tol) {
+		double err = 0;
+		heats.clear();
+		for (int j = 0; j < nLots; j++) {
+			err += lots[j].gen_binned(tol);
+			heats.push_back(lots[j].q_net);
+		};
+		return err;
+	}
+
+	//	arrayHeats_em():	as arrayHeats(), with each column tallied by Euler-Maclaurin summation in O(segments); returns the summed error estimate
+	double arrayHeats_em() {
+		double err = 0;
+		heats.clear();
+		for (int j = 0; j < nLots; j++) {
+			err += lots[j].gen_corr_em();
+			heats.push_back(lots[j].q_net);
+		};
+		return err;
+	}
+
 	//	netHeat():		calculates total heat generated by the array
 	void netHeat() {
 		q_net = 0;
@@ -72,6 +154,15 @@ struct lotArray {
 		};
 	}
 
+	//	energy():		decay energy released by the array between t1 and t2 seconds after generation (kJ for qo in kW)
+	double energy(double t1, double t2) {
+		double e = 0;
+		for (int j = 0; j < int(lots.size()); j++) {
+			e += lots[j].energy(t1, t2);
+		};
+		return e;
+	}
+
 	//	avgflow_req_T():	calculates minimum average flow rate to achieve the desired temperature rise
 	double avgflow_req_T(double& t_rise, double& Cp) {
 		double m_dot_req;		
@@ -106,10 +197,14 @@ struct lotArray {
 	
 };
 
+typedef lotArray_t<ans_tk> lotArray;
+typedef lotArray_t<ans_tk, lot_het_t<ans_tk>> lotArray_het;
+
 //	--== functions ==--
 
 //	flowReqStudy():		determines the flow requirement for an array using multiple t_rise values
-vector <double> flowReqStudy(lotArray& array, vector <double>& t_rises, double &Cp) {
+template <class P, class L>
+vector <double> flowReqStudy(lotArray_t<P, L>& array, vector <double>& t_rises, double &Cp) {
 	vector <double> flow_reqs;
 	double troi = 0;
 	array.arrayGen(troi);
@@ -0,0 +1,178 @@
+//	lot_sim.h
+//	Author:	A. Wells
+//	Date:	2026-10-17
+
+//	Description:
+//	Time-marching simulation of a storage lot over its operating life: elements arrive at a fixed rate, age, and leave after the residence time
+
+#ifndef _LOT_SIM_
+#define _LOT_SIM_
+
+#include <vector>
+
+#include "fe_heat.h"
+#include "csvwrite.h"
+
+//	--== structs ==--
+
+//	lot_sim:	marches a lot forward from an empty store. Stored elements are held in a ring buffer of arrival times sized for one
+//				residence, so each step only admits new arrivals and evicts elements older than <tr>. q_net is then updated either
+//				through a dh_groups backend, where every group's window heat decays by one factor per step and changes only by the
+//				elements entering or leaving (evenly spaced, so each batch adds or removes a geometric series in O(groups)), or
+//				otherwise by Euler-Maclaurin summation of the corrected correlation over the window (O(corr_fin segments) per step).
+//				Either way a series of D steps over N elements costs O(D + N) rather than a gen_corr per step. Templated on a
+//				correlation policy from decay_heat.h.
+template <class P>
+struct lot_sim_t {
+	double	to;					//length of operation prior to discharge
+	double	qo;					//avg element power prior to discharge
+	double	tr;					//residence time
+	double	rate;				//arrival rate; element k arrives at k / rate
+	double	t;					//simulation clock (s)
+	long long n_in;				//elements admitted so far
+	vector <double> ring;		//arrival times of stored elements, oldest at <head>
+	int		head;
+	int		count;				//elements in store
+	const dh_groups* grp;		//backend for incremental updates; nullptr uses the correlation
+	vector <double> w;			//heat of the stored elements per group
+	vector <double> decay;		//per-group decay factor over the last step length
+	double	dt_c;				//step length <decay> was computed for
+	long long n_step;			//steps taken, for periodic resynchronization of <w>
+	double	q_net;				//heat of the stored elements
+	double	err;				//Euler-Maclaurin error estimate for the last step (kW); 0 on the groups backend
+	vector <double> times;		//series clock values
+	vector <double> heats;		//series q_net values
+
+	lot_sim_t() = default;
+	lot_sim_t(const lot_t<P>& l, const dh_groups* g = nullptr) {
+		to = l.to;
+		qo = l.qo;
+		tr = l.tr;
+		rate = l.rate;
+		grp = g;
+		reset();
+	}
+
+	//	reset():	empties the store and the series and sets the clock to 0
+	void reset() {
+		t = 0;
+		n_in = 0;
+		ring.assign(int(floor(tr * rate)) + 2, 0);
+		head = 0;
+		count = 0;
+		w.assign(grp != nullptr ? grp->amp.size() : 0, 0);
+		decay.assign(w.size(), 1);
+		dt_c = 0;
+		n_step = 0;
+		q_net = 0;
+		err = 0;
+		times.clear();
+		heats.clear();
+	}
+
+	//	part():		heat in group i of m elements spaced 1 / rate apart, the youngest at cooling time age
+	double part(int i, double age, long long m) const {
+		double l = grp->lam[i];
+		double h = 1 / rate;
+		return -qo * grp->amp[i] * exp(-l * age) * expm1(-l * to) * expm1(-l * h * m) / expm1(-l * h);
+	}
+
+	//	resync():	rebuilds <w> from the store, bounding the rounding drift of the incremental updates
+	void resync() {
+		for (int i = 0; i < int(w.size()); i++) {
+			w[i] = (count > 0) ? part(i, t - ring[(head + count - 1) % ring.size()], count) : 0;
+		};
+	}
+
+	//	step():		advances the clock by dt, ages the store, admits arrivals up to the new time, evicts elements past <tr>
+	void step(double dt) {
+		t += dt;
+		if (dt != dt_c) {
+			for (int i = 0; i < int(w.size()); i++) {
+				decay[i] = exp(-grp->lam[i] * dt);
+			};
+			dt_c = dt;
+		}
+		for (int i = 0; i < int(w.size()); i++) {
+			w[i] *= decay[i];
+		};
+		int m = 0;
+		while (m < count && t - ring[(head + m) % ring.size()] > tr) {		//exits
+			m++;
+		};
+		if (m > 0) {
+			double youngest = t - ring[(head + m - 1) % ring.size()];
+			for (int i = 0; i < int(w.size()); i++) {
+				w[i] -= part(i, youngest, m);
+			};
+			head = (head + m) % ring.size();
+			count -= m;
+		}
+		double t_next = (n_in + 1) / rate;
+		if (t - t_next > tr) {								//arrivals that would already have left are skipped
+			n_in = (long long)(ceil((t - tr) * rate)) - 1;
+			t_next = (n_in + 1) / rate;
+		}
+		m = 0;
+		while (t_next <= t) {								//entries
+			ring[(head + count) % ring.size()] = t_next;
+			count++;
+			n_in++;
+			m++;
+			t_next = (n_in + 1) / rate;
+		};
+		if (m > 0) {
+			double youngest = t - ring[(head + count - 1) % ring.size()];
+			for (int i = 0; i < int(w.size()); i++) {
+				w[i] += part(i, youngest, m);
+			};
+		}
+		n_step++;
+		if (grp != nullptr) {
+			if (n_step % 1024 == 0) {
+				resync();
+			}
+			q_net = 0;
+			for (int i = 0; i < int(w.size()); i++) {
+				q_net += w[i];
+			};
+		}
+		else if (count > 0) {								//arrivals are evenly spaced, so the store is one Euler-Maclaurin run from its newest element
+			double newest = ring[(head + count - 1) % ring.size()];
+			q_net = qo * corr_fin_sum<P>(t - newest, 1 / rate, count, to, err);
+			err *= qo;
+		}
+		else {
+			q_net = 0;
+			err = 0;
+		}
+	}
+
+	//	run():		steps by dt until the clock reaches t_end, appending each step's q_net to the series
+	void run(double t_end, double dt) {
+		long long n = (long long)(ceil((t_end - t) / dt - 1e-9));
+		times.reserve(times.size() + n);
+		heats.reserve(heats.size() + n);
+		for (long long k = 0; k < n; k++) {
+			step(dt);
+			times.push_back(t);
+			heats.push_back(q_net);
+		};
+	}
+
+	//	exp_series():	exports the series to a local .csv
+	void exp_series(string& filename) {
+		vector <double> csv_output;
+		for (int i = 0; i < times.size(); i++) {
+			csv_output.push_back(times[i]);
+			csv_output.push_back(heats[i]);
+		};
+		int csv_width = 2;
+		int csv_length = int(times.size());
+		write2csv(csv_output, filename, csv_width, csv_length);
+	}
+};
+
+typedef lot_sim_t<ans_tk> lot_sim;
+
+#endif
@@ -0,0 +1,118 @@
+//	parallel.h
+//	Author:	A. Wells
+//	Date:	2026-10-17
+
+//	Description:
+//	Thread helpers shared by the study drivers: a worker count, a static split of an index range over std::thread workers, and
+//	summation whose result does not depend on the number of workers
+
+#ifndef _PARALLEL_
+#define _PARALLEL_
+
+#include <thread>
+#include <vector>
+#include <cmath>
+
+//	--== functions ==--
+
+//	n_threads:	worker count for a requested nt; 0 picks the hardware thread count, falling back to 1 if it is unknown
+inline int n_threads(int nt = 0) {
+	if (nt > 0) {
+		return nt;
+	}
+	int hw = int(std::thread::hardware_concurrency());
+	return hw > 0 ? hw : 1;
+}
+
+//	par_for:	splits [0, n) into nt contiguous chunks and calls f(w, i0, i1) for chunk w on its own thread, chunk 0 on the caller.
+//				Chunk bounds depend only on n and nt, so per-chunk results combined in chunk order are reproducible run to run.
+template <class F>
+void par_for(long long n, int nt, F f) {
+	nt = n_threads(nt);
+	if (nt > n) {
+		nt = n > 0 ? int(n) : 1;
+	}
+	std::vector <std::thread> pool;
+	for (int w = 1; w < nt; w++) {
+		pool.push_back(std::thread(f, w, n * w / nt, n * (w + 1) / nt));
+	};
+	f(0, 0, n / nt);
+	for (int w = 0; w < int(pool.size()); w++) {
+		pool[w].join();
+	};
+}
+
+//	--== reductions ==--
+//	Sums are cut into fixed chunks of red_chunk terms. Each chunk is summed with compensation and the chunk sums are combined
+//	pairwise in index order, so the shape of the sum, and every rounding in it, is fixed by n alone. Workers only decide who
+//	computes which chunk, so results are bitwise identical on any thread count. Compensation relies on strict IEEE evaluation
+//	(MSVC /fp:precise, the project default); value-unsafe flags such as /fp:fast or -ffast-math may fold it away.
+
+const long long red_chunk = 4096;		//terms per chunk
+
+//	neu_acc:	Neumaier compensated accumulator
+struct neu_acc {
+	double s = 0;		//running sum
+	double c = 0;		//running compensation
+
+	void add(double x) {
+		double t = s + x;
+		c += (fabs(s) >= fabs(x)) ? (s - t) + x : (x - t) + s;
+		s = t;
+	}
+
+	double value() const {
+		return s + c;
+	}
+};
+
+//	chunk_sum:	compensated sum of x[0..n) over four interleaved accumulators, merged in a fixed order
+inline double chunk_sum(const double* x, long long n) {
+	neu_acc a[4];
+	long long i = 0;
+	for (; i + 4 <= n; i += 4) {
+		a[0].add(x[i]);
+		a[1].add(x[i + 1]);
+		a[2].add(x[i + 2]);
+		a[3].add(x[i + 3]);
+	};
+	for (; i < n; i++) {
+		a[0].add(x[i]);
+	};
+	neu_acc r;
+	for (int j = 0; j < 4; j++) {
+		r.add(a[j].s);
+	};
+	for (int j = 0; j < 4; j++) {
+		r.add(a[j].c);
+	};
+	return r.value();
+}
+
+//	pair_sum:	pairwise sum of v[0..n), split at n / 2
+inline double pair_sum(const double* v, long long n) {
+	if (n <= 8) {
+		double s = 0;
+		for (long long i = 0; i < n; i++) {
+			s += v[i];
+		};
+		return s;
+	}
+	long long h = n / 2;
+	return pair_sum(v, h) + pair_sum(v + h, n - h);
+}
+
+//	det_sum:	sum of x[0..n) on nt workers, independent of nt
+inline double det_sum(const double* x, long long n, int nt = 0) {
+	long long nc = (n + red_chunk - 1) / red_chunk;
+	std::vector <double> part(nc);
+	par_for(nc, nt, [&](int, long long c0, long long c1) {
+		for (long long c = c0; c < c1; c++) {
+			long long i0 = c * red_chunk;
+			part[c] = chunk_sum(x + i0, (n - i0 < red_chunk) ? n - i0 : red_chunk);
+		};
+	});
+	return pair_sum(part.data(), nc);
+}
+
+#endif
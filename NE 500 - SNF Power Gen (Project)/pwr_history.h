@@ -0,0 +1,91 @@
+//	pwr_history.h
+//	Author:	A. Wells
+//	Date:	2026-10-17
+
+//	Description:
+//	Superposes decay_heat.h contributions over a piecewise-constant power history, as an alternative to a constant power <qo> held for <to>
+
+#ifndef _PWR_HISTORY_
+#define _PWR_HISTORY_
+
+#include <vector>
+
+#include "decay_heat.h"
+
+//	--== structs ==--
+
+//	pwr_history:	piecewise-constant operating history ending at s/d; segment k holds power pwr[k] for dur[k] seconds, oldest first.
+//					Each segment contributes as its own ans_fin irradiation cooled by the time since that segment ended. Adjacent
+//					segments share an ans_inf evaluation at their common edge, so a query costs segments + 1 ans_inf calls. When
+//					built with a dh_groups backend, per-group heat is also carried forward as segments are added, so the group
+//					path costs O(groups) per query and per time step regardless of history length
+struct pwr_history {
+	std::vector <double> dur;		//segment durations (s)
+	std::vector <double> pwr;		//segment powers; set to 1 for fractions of full power
+	double t_op;					//total length of the history (s)
+	dh_groups grp;					//optional multi-group backend
+	std::vector <double> g_state;	//heat of each group at s/d, updated by add()
+
+	pwr_history() {
+		t_op = 0;
+	}
+	pwr_history(const dh_groups& g) {
+		t_op = 0;
+		grp = g;
+		g_state.assign(g.amp.size(), 0);
+	}
+
+	//	add():		appends a segment of d seconds at power p to the end of the history
+	void add(double d, double p) {
+		dur.push_back(d);
+		pwr.push_back(p);
+		t_op += d;
+		for (int i = 0; i < int(g_state.size()); i++) {			//decays existing group heat through the new segment and adds its buildup
+			double l = grp.lam[i];
+			g_state[i] = g_state[i] * exp(-l * d) - p * grp.amp[i] * expm1(-l * d);
+		};
+	}
+
+	//	clear():	removes all segments, keeping the group backend
+	void clear() {
+		dur.clear();
+		pwr.clear();
+		t_op = 0;
+		g_state.assign(grp.amp.size(), 0);
+	}
+
+	//	ans():		uncorrected decay heat at ts seconds after s/d, superposing ans_fin over the segments
+	template <class P = ans_tk>
+	double ans(double ts) const {
+		double q = 0;
+		double a = ts;									//cooling time since the end of segment k
+		double f_a = ans_inf_bf<P>(a);
+		for (int k = int(dur.size()) - 1; k >= 0; k--) {
+			double b = a + dur[k];
+			double f_b = ans_inf_bf<P>(b);
+			q += pwr[k] * (f_a - f_b);
+			a = b;
+			f_a = f_b;
+		};
+		return q;
+	}
+
+	//	corr():		corrected decay heat at ts seconds after s/d; the correction factor is a function of the time since s/d, so it
+	//				scales ans(ts) once rather than each segment, which keeps the result independent of how a constant power
+	//				stretch is split and equal to corr_fin for a single segment
+	template <class P = ans_tk>
+	double corr(double ts) const {
+		return ans<P>(ts) * P::cf(ts);
+	}
+
+	//	groups():	decay heat at ts seconds after s/d through the group backend, from the carried group state
+	double groups(double ts) const {
+		double q = 0;
+		for (int i = 0; i < int(g_state.size()); i++) {
+			q += g_state[i] * exp(-grp.lam[i] * ts);
+		};
+		return q;
+	}
+};
+
+#endif
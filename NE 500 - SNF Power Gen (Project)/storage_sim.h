@@ -0,0 +1,255 @@
+//	storage_sim.h
+//	Author:	A. Wells
+//	Date:	2026-10-17
+
+//	Description:
+//	Discrete-event simulation of a storage facility built from lot_het columns: discharge arrivals, transfers between columns, removals to dry storage and outages, with heat per column recorded over time
+
+#ifndef _STORAGE_SIM_
+#define _STORAGE_SIM_
+
+#include <vector>
+#include <queue>
+#include <functional>
+
+#include "heat_source.h"
+#include "csvwrite.h"
+
+//	--== structs ==--
+
+//	ev_kind:	event types handled by storage_sim
+enum ev_kind {
+	EV_ARRIVE,		//one element discharged into column a; with x > 0, repeats every x seconds, cycling through the columns
+	EV_TRANSFER,	//x elements moved from column a to column b, first in first out
+	EV_REMOVE,		//x elements removed from column a to dry storage, first in first out
+	EV_OUTAGE,		//reactor outage of x seconds; arrivals falling inside it are deferred to its end
+	EV_SAMPLE		//heat of every column recorded; with x > 0, repeats every x seconds
+};
+
+//	sim_event:	queue entry; ties in time are broken by scheduling order
+struct sim_event {
+	double t;			//event time (s)
+	long long seq;		//scheduling order
+	int kind;			//ev_kind
+	int a;				//source column
+	int b;				//destination column
+	double x;			//count, duration or repeat interval, by kind
+
+	bool operator>(const sim_event& o) const {
+		return t > o.t || (t == o.t && seq > o.seq);
+	}
+};
+
+//	storage_sim:	event-driven storage facility. Events sit in a binary-heap queue and each one touches only the columns it names.
+//					With a dh_groups backend every column carries its heat per group as of its last update, so an event decays the
+//					named columns to the current time and adds or subtracts the elements that moved, and a sample costs O(groups)
+//					per column; without one, columns are evaluated with corr_fin_batch_to at each sample, O(elements). Column
+//					elements are lot_het_t arrays consumed from <head>, so transfers and removals take the oldest arrivals first.
+template <class P>
+struct storage_sim_t {
+	struct column {
+		lot_het_t<P> els;			//elements, oldest first from <head>
+		long long head;				//first element still in the column
+		vector <double> w;			//heat per group at <t_ref>
+		double t_ref;				//time <w> was last brought up to
+		long long n_touch;			//updates since <w> was last rebuilt
+	};
+
+	vector <column> cols;
+	double	to;					//operating period given to arriving elements (s)
+	double	qo;					//avg power given to arriving elements
+	const dh_groups* grp;		//backend for incremental column heat; nullptr evaluates the correlation at samples
+	std::priority_queue <sim_event, vector <sim_event>, std::greater <sim_event>> queue;
+	long long seq;				//events scheduled so far
+	long long n_events;			//events processed
+	double	now;				//simulation clock (s)
+	double	paused_until;		//end of the current outage
+	int		next_col;			//column the next cycling arrival goes to
+	vector <double> times;		//sample times
+	vector <double> heats;		//column heats at each sample, one row of cols.size() values per sample
+	dh_status status;			//out-of-range tally over all samples
+
+	storage_sim_t() = default;
+	storage_sim_t(int n_cols, double toi, double qoi, const dh_groups* g = nullptr) {
+		to = toi;
+		qo = qoi;
+		grp = g;
+		cols.resize(n_cols);
+		for (int c = 0; c < n_cols; c++) {
+			cols[c].head = 0;
+			cols[c].w.assign(grp != nullptr ? grp->amp.size() : 0, 0);
+			cols[c].t_ref = 0;
+			cols[c].n_touch = 0;
+		};
+		seq = 0;
+		n_events = 0;
+		now = 0;
+		paused_until = -HUGE_VAL;
+		next_col = 0;
+	}
+
+	//	load():		fills the columns from a lotArray snapshot taken at time t0, one array lot per column in turn
+	void load(const lotArray_t<P>& a, double t0) {
+		now = t0;
+		for (int j = 0; j < int(a.lots.size()); j++) {
+			const lot_t<P>& l = a.lots[j];
+			column& c = cols[j % cols.size()];
+			for (int i = l.size; i >= 0; i--) {			//oldest first
+				add(c, t0 - (l.tro + (i + 1) / l.rate), l.to, l.qo);
+			};
+		};
+	}
+
+	//	schedule():	queues an event
+	void schedule(double t, int kind, int a = 0, int b = 0, double x = 0) {
+		queue.push({ t, seq++, kind, a, b, x });
+	}
+
+	//	part():		heat in group i of one element at cooling time age
+	double part(int i, double age, double toi, double qoi) const {
+		return -qoi * grp->amp[i] * exp(-grp->lam[i] * age) * expm1(-grp->lam[i] * toi);
+	}
+
+	//	touch():	decays a column's group heat to the current time, rebuilding it now and then to bound rounding drift
+	void touch(column& c) {
+		if (grp == nullptr) {
+			return;
+		}
+		if (++c.n_touch > std::max <long long>(4096, c.els.size() - c.head)) {		//a rebuild costs O(elements), so spacing rebuilds by the column size keeps it O(1) per update
+			c.n_touch = 0;
+			for (int i = 0; i < int(c.w.size()); i++) {
+				c.w[i] = 0;
+				for (long long e = c.head; e < c.els.size(); e++) {
+					c.w[i] += part(i, now - c.els.td[e], c.els.to[e], c.els.qo[e]);
+				};
+			};
+		}
+		else if (now != c.t_ref) {
+			for (int i = 0; i < int(c.w.size()); i++) {
+				c.w[i] *= exp(-grp->lam[i] * (now - c.t_ref));
+			};
+		}
+		c.t_ref = now;
+	}
+
+	void add(column& c, double td, double toi, double qoi) {
+		touch(c);
+		c.els.add(td, toi, qoi);
+		for (int i = 0; i < int(c.w.size()); i++) {
+			c.w[i] += part(i, now - td, toi, qoi);
+		};
+	}
+
+	//	pop():		removes up to m of the oldest elements of a column, passing each to <sink>
+	template <class F>
+	void pop(column& c, long long m, F sink) {
+		touch(c);
+		for (; m > 0 && c.head < c.els.size(); m--, c.head++) {
+			double td = c.els.td[c.head];
+			double toi = c.els.to[c.head];
+			double qoi = c.els.qo[c.head];
+			for (int i = 0; i < int(c.w.size()); i++) {
+				c.w[i] -= part(i, now - td, toi, qoi);
+			};
+			sink(td, toi, qoi);
+		};
+		if (c.head > 1024 && 2 * c.head > c.els.size()) {		//compacts once half the arrays are consumed, amortized O(1) per element
+			c.els.td.erase(c.els.td.begin(), c.els.td.begin() + c.head);
+			c.els.to.erase(c.els.to.begin(), c.els.to.begin() + c.head);
+			c.els.qo.erase(c.els.qo.begin(), c.els.qo.begin() + c.head);
+			c.head = 0;
+		}
+	}
+
+	//	heat():		current heat of column c
+	double heat(int c) {
+		column& col = cols[c];
+		if (grp != nullptr) {
+			touch(col);
+			double q = 0;
+			for (int i = 0; i < int(col.w.size()); i++) {
+				q += col.w[i];
+			};
+			return q;
+		}
+		double buf[stream_block];
+		double q = 0;
+		long long n = col.els.size();
+		for (long long i0 = col.head; i0 < n; i0 += stream_block) {
+			int m = int(std::min <long long>(stream_block, n - i0));
+			for (int i = 0; i < m; i++) {
+				buf[i] = now - col.els.td[i0 + i];
+			};
+			corr_fin_batch_to<P>(buf, &col.els.to[i0], buf, m, &status);
+			for (int i = 0; i < m; i++) {
+				q += buf[i] * col.els.qo[i0 + i];
+			};
+		};
+		return q;
+	}
+
+	int count(int c) const {
+		return int(cols[c].els.size() - cols[c].head);
+	}
+
+	//	run():		processes queued events up to t_end
+	void run(double t_end) {
+		while (!queue.empty() && queue.top().t <= t_end) {
+			sim_event ev = queue.top();
+			queue.pop();
+			now = ev.t;
+			n_events++;
+			if (ev.kind == EV_ARRIVE) {
+				if (now < paused_until) {
+					schedule(paused_until, ev.kind, ev.a, ev.b, ev.x);
+					continue;
+				}
+				int c = (ev.x > 0) ? next_col : ev.a;
+				add(cols[c], now, to, qo);
+				if (ev.x > 0) {
+					next_col = (next_col + 1) % int(cols.size());
+					schedule(now + ev.x, ev.kind, ev.a, ev.b, ev.x);
+				}
+			}
+			else if (ev.kind == EV_TRANSFER) {
+				column& dst = cols[ev.b];
+				touch(dst);
+				pop(cols[ev.a], (long long)ev.x, [&](double td, double toi, double qoi) { add(dst, td, toi, qoi); });
+			}
+			else if (ev.kind == EV_REMOVE) {
+				pop(cols[ev.a], (long long)ev.x, [](double, double, double) {});
+			}
+			else if (ev.kind == EV_OUTAGE) {
+				paused_until = fmax(paused_until, now + ev.x);
+			}
+			else if (ev.kind == EV_SAMPLE) {
+				times.push_back(now);
+				for (int c = 0; c < int(cols.size()); c++) {
+					heats.push_back(heat(c));
+				};
+				if (ev.x > 0) {
+					schedule(now + ev.x, ev.kind, ev.a, ev.b, ev.x);
+				}
+			}
+		};
+		dh_report(status, "storage_sim");
+	}
+
+	//	exp_heats():	exports the samples to a local .csv, one row per sample with the time followed by each column's heat
+	void exp_heats(string& filename) {
+		int csv_width = int(cols.size()) + 1;
+		int csv_length = int(times.size());
+		vector <double> csv_output;
+		for (int k = 0; k < csv_length; k++) {
+			csv_output.push_back(times[k]);
+			for (int c = 0; c < int(cols.size()); c++) {
+				csv_output.push_back(heats[k * cols.size() + c]);
+			};
+		};
+		write2csv(csv_output, filename, csv_width, csv_length);
+	}
+};
+
+typedef storage_sim_t<ans_tk> storage_sim;
+
+#endif
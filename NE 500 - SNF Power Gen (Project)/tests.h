@@ -10,6 +10,7 @@
 //	--== test select ==--
 bool test_ans_inf = true;
 bool test_ans_fin = true;
+bool test_lot_ad = true;
 
 //	--== decay_heat.h ==--
 
@@ -25,6 +26,16 @@ double ts_test8 = 9000000000;
 
 //	--== fe_heat.h ==--
 
+//	lot_t::gen_corr_ad against central differences for an FHR lot with to = 1E7 s, where ts + to crosses the 4E7 s bin edge
+//	inside the lot window (b - to = 3E7 s). The default to = 44180640 s has no such crossing
+double ad_to = 10000000;
+double ad_q = 0.555;
+double ad_tr = 157788000;
+double ad_tro = 0;
+double ad_rate = 0.009624;
+double ad_h_to = 10000;
+double ad_h_rate = 0.000001;
+
 //	--== heat_source.h ==--
 
 void test() {
@@ -42,4 +53,12 @@ void test() {
 	if (test_ans_fin) {
 		//std::cout << "decay heat @ ts = 1.7E4 s, to = 5E6	= " << ans_fin(ts_test3, ts_test5) << std::endl;	//expected: 7.474E-3
 	}
+	if (test_lot_ad) {
+		//lot ad_lot(ad_to, ad_q, ad_tr, ad_tro, ad_rate);
+		//dual<4> ad_q_net = ad_lot.gen_corr_ad();
+		//double ad_to_p = ad_to + ad_h_to, ad_to_m = ad_to - ad_h_to;
+		//lot ad_p(ad_to_p, ad_q, ad_tr, ad_tro, ad_rate), ad_m(ad_to_m, ad_q, ad_tr, ad_tro, ad_rate);
+		//std::cout << "d/dto   AD = " << ad_q_net.d[0] << ", FD = " << (ad_p.gen_corr_ad().v - ad_m.gen_corr_ad().v) / (2 * ad_h_to) << std::endl;	//expected: 3.039E-6, 3.039E-6
+		//std::cout << "d/drate AD = " << ad_q_net.d[3] << std::endl;	//expected: 6190 (central differences with size relaxed to tr * rate, h = ad_h_rate: 6191)
+	}
 }
\ No newline at end of file
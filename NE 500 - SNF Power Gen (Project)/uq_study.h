@@ -0,0 +1,255 @@
+//	uq_study.h
+//	Author:	A. Wells
+//	Date:	2026-10-17
+
+//	Description:
+//	Monte Carlo propagation of decay heat coefficient uncertainty to lot and lot array heat, run on all cores with streaming percentiles
+
+#ifndef _UQ_STUDY_
+#define _UQ_STUDY_
+
+#include <vector>
+#include <random>
+#include <cmath>
+
+#include "fe_heat.h"
+#include "heat_source.h"
+#include "parallel.h"
+
+//	--== structs ==--
+
+//	dh_kind:	distribution families for dh_dist
+enum dh_kind {
+	DH_FIXED,		//held at the nominal value
+	DH_NORMAL,		//x * (1 + s * z), z standard normal
+	DH_UNIFORM,		//x * (1 + s * u), u uniform on [-1, 1]
+	DH_LOGNORMAL	//x * exp(s * z)
+};
+
+//	dh_dist:	distribution of one coefficient relative to its nominal value; coefficients that are 0 in the fit stay 0
+struct dh_dist {
+	int kind;		//dh_kind
+	double s;		//relative spread
+
+	dh_dist() {
+		kind = DH_FIXED;
+		s = 0;
+	}
+	dh_dist(int k, double si) {
+		kind = k;
+		s = si;
+	}
+
+	double sample(double x, std::mt19937_64& g) const {
+		if (kind == DH_NORMAL) {
+			return x * (1 + s * std::normal_distribution <double>(0, 1)(g));
+		}
+		else if (kind == DH_UNIFORM) {
+			return x * (1 + s * std::uniform_real_distribution <double>(-1, 1)(g));
+		}
+		else if (kind == DH_LOGNORMAL) {
+			return x * exp(s * std::normal_distribution <double>(0, 1)(g));
+		}
+		return x;
+	}
+};
+
+//	dh_unc:		coefficient uncertainty laid out like the ans_tk tables it perturbs, one dh_dist per entry of <form> and <cform>
+struct dh_unc {
+	dh_dist form[5][ans_tk::n_bnd + 1];
+	dh_dist cform[5][ans_tk::n_cbnd + 1];
+
+	//	set_form():		applies d to every entry of <form>
+	void set_form(dh_dist d) {
+		for (int i = 0; i < 5; i++) {
+			for (int k = 0; k < ans_tk::n_bnd + 1; k++) {
+				form[i][k] = d;
+			};
+		};
+	}
+
+	//	set_cform():	applies d to every entry of <cform>
+	void set_cform(dh_dist d) {
+		for (int i = 0; i < 5; i++) {
+			for (int r = 0; r < ans_tk::n_cbnd + 1; r++) {
+				cform[i][r] = d;
+			};
+		};
+	}
+
+	//	draw():			samples every entry and loads the result into ans_tk_var for the calling thread
+	void draw(std::mt19937_64& g) const {
+		double f[5][ans_tk::n_bnd + 1];
+		double c[5][ans_tk::n_cbnd + 1];
+		for (int i = 0; i < 5; i++) {
+			for (int k = 0; k < ans_tk::n_bnd + 1; k++) {
+				f[i][k] = form[i][k].sample(ans_tk::form[i][k], g);
+			};
+			for (int r = 0; r < ans_tk::n_cbnd + 1; r++) {
+				c[i][r] = cform[i][r].sample(ans_tk::cform[i][r], g);
+			};
+		};
+		ans_tk_var::set(f, c);
+	}
+};
+
+//	p_hist:		streaming distribution summary. Samples fall into log-spaced bins over [ref / span, ref * span] (end bins catch the
+//				rest), so percentiles are read to about one bin width without keeping samples; mean, variance, min and max are
+//				exact. Summaries built on separate threads merge by adding counts.
+struct p_hist {
+	double lo;					//lower edge of the first bin
+	double dl;					//bin width in ln
+	std::vector <long long> counts;
+	long long n;				//samples added
+	double mean;
+	double m2;					//sum of squared deviations from the mean
+	double min;
+	double max;
+
+	p_hist() = default;
+	p_hist(double ref, double span = 64, int nb = 8192) {
+		lo = ref / span;
+		dl = 2 * log(span) / nb;
+		counts.assign(nb, 0);
+		n = 0;
+		mean = 0;
+		m2 = 0;
+		min = HUGE_VAL;
+		max = -HUGE_VAL;
+	}
+
+	void add(double x) {
+		long long b = (x > lo) ? (long long)(log(x / lo) / dl) : 0;
+		counts[b < (long long)counts.size() ? b : counts.size() - 1]++;
+		n++;
+		double dx = x - mean;
+		mean += dx / n;
+		m2 += dx * (x - mean);
+		min = fmin(min, x);
+		max = fmax(max, x);
+	}
+
+	//	merge():	adds the samples summarized by o, which must share this summary's bins
+	void merge(const p_hist& o) {
+		if (o.n == 0) {
+			return;
+		}
+		for (int b = 0; b < int(counts.size()); b++) {
+			counts[b] += o.counts[b];
+		};
+		double dx = o.mean - mean;
+		long long nn = n + o.n;
+		mean += dx * o.n / nn;
+		m2 += o.m2 + dx * dx * double(n) * double(o.n) / nn;
+		n = nn;
+		min = fmin(min, o.min);
+		max = fmax(max, o.max);
+	}
+
+	double sd() const {
+		return n > 1 ? sqrt(m2 / (n - 1)) : 0;
+	}
+
+	//	pct():		p-th percentile (0-100), interpolated log-linearly within its bin and clamped to [min, max]
+	double pct(double p) const {
+		double target = p / 100 * n;
+		long long c = 0;
+		for (int b = 0; b < int(counts.size()); b++) {
+			if (counts[b] > 0 && c + counts[b] >= target) {
+				double x = lo * exp(dl * (b + (target - c) / counts[b]));
+				return fmin(fmax(x, min), max);
+			}
+			c += counts[b];
+		};
+		return max;
+	}
+
+	void report(const char* name) const {
+		std::cout << name << ":	n = " << n << ", mean = " << mean << ", sd = " << sd() << ", p5 = " << pct(5) << ", p50 = " << pct(50) << ", p95 = " << pct(95) << std::endl;
+	}
+};
+
+//	--== functions ==--
+//	Sample s draws from its own mt19937_64 seeded by {seed, s}, so each sample's coefficients depend only on the seed and its index,
+//	not on the thread that evaluates it. Lots are evaluated by gen_corr_em (O(segments) per lot) unless <em> is false.
+
+//	uq_stream:	seeds the generator for sample s
+inline std::mt19937_64 uq_stream(unsigned long long seed, long long s) {
+	std::seed_seq ss = { (unsigned)(seed >> 32), (unsigned)seed, (unsigned)(s >> 32), (unsigned)s };
+	return std::mt19937_64(ss);
+}
+
+//	uq_lot:		lumped heat of refLot (kW) over n_samp coefficient samples drawn from u
+template <class P>
+p_hist uq_lot(const lot_t<P>& refLot, const dh_unc& u, long long n_samp, unsigned long long seed, int nt = 0, bool em = true) {
+	lot_t<ans_tk_var> nom(refLot);
+	ans_tk_var::reset();
+	nom.gen_corr_em();
+	nt = n_threads(nt);
+	std::vector <p_hist> part(nt, p_hist(nom.q_net));
+	std::vector <dh_status> st(nt);
+	par_for(n_samp, nt, [&](int w, long long i0, long long i1) {
+		lot_t<ans_tk_var> l(refLot);
+		for (long long s = i0; s < i1; s++) {
+			std::mt19937_64 g = uq_stream(seed, s);
+			u.draw(g);
+			if (em) {
+				l.gen_corr_em();
+			}
+			else {
+				l.gen_corr_par(1, false);		//out-of-range tallies are gathered per worker and reported after the join
+				st[w].tally(l.status.n_low, l.status.n_high, l.status.n_tse_high);
+			}
+			part[w].add(l.q_net);
+		};
+		ans_tk_var::reset();
+	});
+	for (int w = 1; w < nt; w++) {
+		part[0].merge(part[w]);
+		st[0].tally(st[w].n_low, st[w].n_high, st[w].n_tse_high);
+	};
+	dh_report(st[0], "uq_study");
+	return part[0];
+}
+
+//	uq_array:	net heat of refArray (kW) over n_samp coefficient samples drawn from u; refArray's lots must already be generated
+template <class P>
+p_hist uq_array(const lotArray_t<P>& refArray, const dh_unc& u, long long n_samp, unsigned long long seed, int nt = 0, bool em = true) {
+	auto net = [em](lotArray_t<ans_tk_var>& a, dh_status& st) {
+		a.heats.clear();
+		for (int j = 0; j < int(a.lots.size()); j++) {
+			if (em) {
+				a.lots[j].gen_corr_em();
+			}
+			else {
+				a.lots[j].gen_corr_par(1, false);		//out-of-range tallies are gathered in <st> and reported after the join
+				st.tally(a.lots[j].status.n_low, a.lots[j].status.n_high, a.lots[j].status.n_tse_high);
+			}
+			a.heats.push_back(a.lots[j].q_net);
+		};
+		a.netHeat();
+		return a.q_net;
+	};
+	lotArray_t<ans_tk_var> nom(refArray);
+	ans_tk_var::reset();
+	nt = n_threads(nt);
+	std::vector <dh_status> st(nt);
+	std::vector <p_hist> part(nt, p_hist(net(nom, st[0])));
+	par_for(n_samp, nt, [&](int w, long long i0, long long i1) {
+		lotArray_t<ans_tk_var> a(refArray);
+		for (long long s = i0; s < i1; s++) {
+			std::mt19937_64 g = uq_stream(seed, s);
+			u.draw(g);
+			part[w].add(net(a, st[w]));
+		};
+		ans_tk_var::reset();
+	});
+	for (int w = 1; w < nt; w++) {
+		part[0].merge(part[w]);
+		st[0].tally(st[w].n_low, st[w].n_high, st[w].n_tse_high);
+	};
+	dh_report(st[0], "uq_study");
+	return part[0];
+}
+
+#endif